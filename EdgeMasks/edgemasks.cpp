@@ -22,358 +22,622 @@
     SOFTWARE.
 */
 
-#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <random>
 
 #include "edgemasks.h"
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace std::string_literals;
 
-#ifdef EDGEMASKS_X86
-template<typename pixel_t, int Operator, bool euclidean>
-extern void filterSSE4(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
+ThreadPool::ThreadPool(int workers) {
+    for (int i = 0; i < workers; i++)
+        this->workers.emplace_back([this] {
+            std::unique_lock guard(lock);
 
-template<typename pixel_t, int Operator, bool euclidean>
-extern void filterAVX2(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
+            while (true) {
+                pending.wait(guard, [this] { return stop || !queue.empty(); });
 
-template<typename pixel_t, int Operator, bool euclidean>
-extern void filterAVX512(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-#endif
+                if (queue.empty())
+                    return;
 
-template<typename pixel_t, int Operator, bool euclidean>
-static void filterC(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept {
-    using scalar_t = std::conditional_t<std::is_integral_v<pixel_t>, int, float>;
-
-    for (int plane = 0; plane < d->vi->format.numPlanes; plane++) {
-        if (d->process[plane]) {
-            const int width = vsapi->getFrameWidth(src, plane);
-            const int height = vsapi->getFrameHeight(src, plane);
-            const ptrdiff_t stride = vsapi->getStride(src, plane) / sizeof(pixel_t);
-            auto srcp0 = reinterpret_cast<const pixel_t*>(vsapi->getReadPtr(src, plane));
-            auto dstp = reinterpret_cast<pixel_t*>(vsapi->getWritePtr(dst, plane));
-
-            pixel_t a00, a01, a02, a03, a04;
-            pixel_t a10, a11, a12, a13, a14;
-            pixel_t a20, a21, a22, a23, a24;
-            pixel_t a30, a31, a32, a33, a34;
-            pixel_t a40, a41, a42, a43, a44;
-
-            auto detect = [&]() noexcept {
-                scalar_t gx, gy;
-                float g;
-
-                if constexpr (Operator == Tritical) {
-                    gx = a10 - a12;
-                    gy = a01 - a21;
-                } else if constexpr (Operator == Cross) {
-                    gx = a00 - a22;
-                    gy = a02 - a20;
-                } else if constexpr (Operator == Prewitt) {
-                    gx = a00 + a10 + a20 - a02 - a12 - a22;
-                    gy = a00 + a01 + a02 - a20 - a21 - a22;
-                } else if constexpr (Operator == Sobel) {
-                    gx = a00 + 2 * a10 + a20 - a02 - 2 * a12 - a22;
-                    gy = a00 + 2 * a01 + a02 - a20 - 2 * a21 - a22;
-                } else if constexpr (Operator == Scharr) {
-                    gx = 3 * (a00 + a20) + 10 * a10 - 3 * (a02 + a22) - 10 * a12;
-                    gy = 3 * (a00 + a02) + 10 * a01 - 3 * (a20 + a22) - 10 * a21;
-                } else if constexpr (Operator == RScharr) {
-                    gx = 47 * (a00 + a20) + 162 * a10 - 47 * (a02 + a22) - 162 * a12;
-                    gy = 47 * (a00 + a02) + 162 * a01 - 47 * (a20 + a22) - 162 * a21;
-                } else if constexpr (Operator == Kroon) {
-                    gx = 17 * (a00 + a20) + 61 * a10 - 17 * (a02 + a22) - 61 * a12;
-                    gy = 17 * (a00 + a02) + 61 * a01 - 17 * (a20 + a22) - 61 * a21;
-                } else if constexpr (Operator == Robinson3) {
-                    const scalar_t g1 = a02 + a01 + a00 - a20 - a21 - a22;
-                    const scalar_t g2 = a01 + a00 + a10 - a21 - a22 - a12;
-                    const scalar_t g3 = a00 + a10 + a20 - a22 - a12 - a02;
-                    const scalar_t g4 = a10 + a20 + a21 - a12 - a02 - a01;
-                    g = std::max({ std::abs(g1), std::abs(g2), std::abs(g3), std::abs(g4) });
-                } else if constexpr (Operator == Robinson5) {
-                    const scalar_t g1 = a02 + 2 * a01 + a00 - a20 - 2 * a21 - a22;
-                    const scalar_t g2 = a01 + 2 * a00 + a10 - a21 - 2 * a22 - a12;
-                    const scalar_t g3 = a00 + 2 * a10 + a20 - a22 - 2 * a12 - a02;
-                    const scalar_t g4 = a10 + 2 * a20 + a21 - a12 - 2 * a02 - a01;
-                    g = std::max({ std::abs(g1), std::abs(g2), std::abs(g3), std::abs(g4) });
-                } else if constexpr (Operator == Kirsch) {
-                    const scalar_t g1 = 5 * (a02 + a01 + a00) - 3 * (a10 + a20 + a21 + a22 + a12);
-                    const scalar_t g2 = 5 * (a01 + a00 + a10) - 3 * (a20 + a21 + a22 + a12 + a02);
-                    const scalar_t g3 = 5 * (a00 + a10 + a20) - 3 * (a21 + a22 + a12 + a02 + a01);
-                    const scalar_t g4 = 5 * (a10 + a20 + a21) - 3 * (a22 + a12 + a02 + a01 + a00);
-                    const scalar_t g5 = 5 * (a20 + a21 + a22) - 3 * (a12 + a02 + a01 + a00 + a10);
-                    const scalar_t g6 = 5 * (a21 + a22 + a12) - 3 * (a02 + a01 + a00 + a10 + a20);
-                    const scalar_t g7 = 5 * (a22 + a12 + a02) - 3 * (a01 + a00 + a10 + a20 + a21);
-                    const scalar_t g8 = 5 * (a12 + a02 + a01) - 3 * (a00 + a10 + a20 + a21 + a22);
-                    g = std::max({ std::abs(g1), std::abs(g2), std::abs(g3), std::abs(g4), std::abs(g5), std::abs(g6), std::abs(g7), std::abs(g8) });
-                } else if constexpr (Operator == ExPrewitt) {
-                    gx = 2 * (a00 + a10 + a20 + a30 + a40) + a01 + a11 + a21 + a31 + a41
-                        - a03 - a13 - a23 - a33 - a43 - 2 * (a04 + a14 + a24 + a34 + a44);
-                    gy = 2 * (a00 + a01 + a02 + a03 + a04) + a10 + a11 + a12 + a13 + a14
-                        - a30 - a31 - a32 - a33 - a34 - 2 * (a40 + a41 + a42 + a43 + a44);
-                } else if constexpr (Operator == ExSobel) {
-                    gx = 2 * (a00 + a10 + a30 + a40) + 4 * a20 + a01 + a11 + 2 * a21 + a31 + a41
-                        - a03 - a13 - 2 * a23 - a33 - a43 - 2 * (a04 + a14 + a34 + a44) - 4 * a24;
-                    gy = 2 * (a00 + a01 + a03 + a04) + 4 * a02 + a10 + a11 + 2 * a12 + a13 + a14
-                        - a30 - a31 - 2 * a32 - a33 - a34 - 2 * (a40 + a41 + a43 + a44) - 4 * a42;
-                } else if constexpr (Operator == FDoG) {
-                    gx = a00 + a01 + a40 + a41 + 2 * (a10 + a11 + a30 + a31) + 3 * (a20 + a21)
-                        - a03 - a04 - a43 - a44 - 2 * (a13 + a14 + a33 + a34) - 3 * (a23 + a24);
-                    gy = a00 + a10 + a04 + a14 + 2 * (a01 + a11 + a03 + a13) + 3 * (a02 + a12)
-                        - a30 - a40 - a34 - a44 - 2 * (a31 + a41 + a33 + a43) - 3 * (a32 + a42);
-                } else if constexpr (Operator == ExKirsch) {
-                    const scalar_t g1 = 9 * (a14 + a04 + a03 + a02 + a01 + a00 + a10) - 7 * (a20 + a30 + a40 + a41 + a42 + a43 + a44 + a34 + a24)
-                        + 5 * (a13 + a12 + a11) - 3 * (a21 + a31 + a32 + a33 + a23);
-                    const scalar_t g2 = 9 * (a03 + a02 + a01 + a00 + a10 + a20 + a30) - 7 * (a40 + a41 + a42 + a43 + a44 + a34 + a24 + a14 + a04)
-                        + 5 * (a12 + a11 + a21) - 3 * (a31 + a32 + a33 + a23 + a13);
-                    const scalar_t g3 = 9 * (a01 + a00 + a10 + a20 + a30 + a40 + a41) - 7 * (a42 + a43 + a44 + a34 + a24 + a14 + a04 + a03 + a02)
-                        + 5 * (a11 + a21 + a31) - 3 * (a32 + a33 + a23 + a13 + a12);
-                    const scalar_t g4 = 9 * (a10 + a20 + a30 + a40 + a41 + a42 + a43) - 7 * (a44 + a34 + a24 + a14 + a04 + a03 + a02 + a01 + a00)
-                        + 5 * (a21 + a31 + a32) - 3 * (a33 + a23 + a13 + a12 + a11);
-                    const scalar_t g5 = 9 * (a30 + a40 + a41 + a42 + a43 + a44 + a34) - 7 * (a24 + a14 + a04 + a03 + a02 + a01 + a00 + a10 + a20)
-                        + 5 * (a31 + a32 + a33) - 3 * (a23 + a13 + a12 + a11 + a21);
-                    const scalar_t g6 = 9 * (a41 + a42 + a43 + a44 + a34 + a24 + a14) - 7 * (a04 + a03 + a02 + a01 + a00 + a10 + a20 + a30 + a40)
-                        + 5 * (a32 + a33 + a23) - 3 * (a13 + a12 + a11 + a21 + a31);
-                    const scalar_t g7 = 9 * (a43 + a44 + a34 + a24 + a14 + a04 + a03) - 7 * (a02 + a01 + a00 + a10 + a20 + a30 + a40 + a41 + a42)
-                        + 5 * (a33 + a23 + a13) - 3 * (a12 + a11 + a21 + a31 + a32);
-                    const scalar_t g8 = 9 * (a34 + a24 + a14 + a04 + a03 + a02 + a01) - 7 * (a00 + a10 + a20 + a30 + a40 + a41 + a42 + a43 + a44)
-                        + 5 * (a23 + a13 + a12) - 3 * (a11 + a21 + a31 + a32 + a33);
-                    g = std::max({ std::abs(g1), std::abs(g2), std::abs(g3), std::abs(g4), std::abs(g5), std::abs(g6), std::abs(g7), std::abs(g8) });
-                }
+                Batch* batch = queue.front();
+                const int index = batch->next++;
 
-                if constexpr (euclidean)
-                    g = std::sqrt(static_cast<float>(gx) * gx + static_cast<float>(gy) * gy);
+                if (batch->next == batch->count)
+                    queue.pop_front();
 
-                g *= d->scale[plane];
+                guard.unlock();
+                (*batch->task)(index);
+                guard.lock();
 
-                if constexpr (std::is_integral_v<pixel_t>)
-                    return std::min(static_cast<int>(g + 0.5f), d->peak);
-                else
-                    return g;
-            };
+                if (++batch->done == batch->count)
+                    finished.notify_all();
+            }
+        });
+}
 
-            for (int y = 0; y < height; y++) {
-                auto prev1 = (y == 0) ? srcp0 + stride : srcp0 - stride;
-                auto next1 = (y == height - 1) ? srcp0 - stride : srcp0 + stride;
-
-                if (d->matrix == 3) {
-                    int x = 0;
-                    a00 = prev1[x + 1]; a01 = prev1[x]; a02 = prev1[x + 1];
-                    a10 = srcp0[x + 1]; a11 = srcp0[x]; a12 = srcp0[x + 1];
-                    a20 = next1[x + 1]; a21 = next1[x]; a22 = next1[x + 1];
-                    dstp[x] = detect();
-
-                    for (x = 1; x < width - 1; x++) {
-                        a00 = prev1[x - 1]; a01 = prev1[x]; a02 = prev1[x + 1];
-                        a10 = srcp0[x - 1]; a11 = srcp0[x]; a12 = srcp0[x + 1];
-                        a20 = next1[x - 1]; a21 = next1[x]; a22 = next1[x + 1];
-                        dstp[x] = detect();
-                    }
-
-                    x = width - 1;
-                    a00 = prev1[x - 1]; a01 = prev1[x]; a02 = prev1[x - 1];
-                    a10 = srcp0[x - 1]; a11 = srcp0[x]; a12 = srcp0[x - 1];
-                    a20 = next1[x - 1]; a21 = next1[x]; a22 = next1[x - 1];
-                    dstp[x] = detect();
-                } else {
-                    auto prev2 = (y == 0) ? srcp0 + stride * 2 : (y == 1 ? srcp0 : srcp0 - stride * 2);
-                    auto next2 = (y == height - 1) ? srcp0 - stride * 2 : (y == height - 2 ? srcp0 : srcp0 + stride * 2);
-
-                    int x = 0;
-                    a00 = prev2[x + 2]; a01 = prev2[x + 1]; a02 = prev2[x]; a03 = prev2[x + 1]; a04 = prev2[x + 2];
-                    a10 = prev1[x + 2]; a11 = prev1[x + 1]; a12 = prev1[x]; a13 = prev1[x + 1]; a14 = prev1[x + 2];
-                    a20 = srcp0[x + 2]; a21 = srcp0[x + 1]; a22 = srcp0[x]; a23 = srcp0[x + 1]; a24 = srcp0[x + 2];
-                    a30 = next1[x + 2]; a31 = next1[x + 1]; a32 = next1[x]; a33 = next1[x + 1]; a34 = next1[x + 2];
-                    a40 = next2[x + 2]; a41 = next2[x + 1]; a42 = next2[x]; a43 = next2[x + 1]; a44 = next2[x + 2];
-                    dstp[x] = detect();
-
-                    x = 1;
-                    a00 = prev2[x]; a01 = prev2[x - 1]; a02 = prev2[x]; a03 = prev2[x + 1]; a04 = prev2[x + 2];
-                    a10 = prev1[x]; a11 = prev1[x - 1]; a12 = prev1[x]; a13 = prev1[x + 1]; a14 = prev1[x + 2];
-                    a20 = srcp0[x]; a21 = srcp0[x - 1]; a22 = srcp0[x]; a23 = srcp0[x + 1]; a24 = srcp0[x + 2];
-                    a30 = next1[x]; a31 = next1[x - 1]; a32 = next1[x]; a33 = next1[x + 1]; a34 = next1[x + 2];
-                    a40 = next2[x]; a41 = next2[x - 1]; a42 = next2[x]; a43 = next2[x + 1]; a44 = next2[x + 2];
-                    dstp[x] = detect();
-
-                    for (x = 2; x < width - 2; x++) {
-                        a00 = prev2[x - 2]; a01 = prev2[x - 1]; a02 = prev2[x]; a03 = prev2[x + 1]; a04 = prev2[x + 2];
-                        a10 = prev1[x - 2]; a11 = prev1[x - 1]; a12 = prev1[x]; a13 = prev1[x + 1]; a14 = prev1[x + 2];
-                        a20 = srcp0[x - 2]; a21 = srcp0[x - 1]; a22 = srcp0[x]; a23 = srcp0[x + 1]; a24 = srcp0[x + 2];
-                        a30 = next1[x - 2]; a31 = next1[x - 1]; a32 = next1[x]; a33 = next1[x + 1]; a34 = next1[x + 2];
-                        a40 = next2[x - 2]; a41 = next2[x - 1]; a42 = next2[x]; a43 = next2[x + 1]; a44 = next2[x + 2];
-                        dstp[x] = detect();
-                    }
-
-                    x = width - 2;
-                    a00 = prev2[x - 2]; a01 = prev2[x - 1]; a02 = prev2[x]; a03 = prev2[x + 1]; a04 = prev2[x];
-                    a10 = prev1[x - 2]; a11 = prev1[x - 1]; a12 = prev1[x]; a13 = prev1[x + 1]; a14 = prev1[x];
-                    a20 = srcp0[x - 2]; a21 = srcp0[x - 1]; a22 = srcp0[x]; a23 = srcp0[x + 1]; a24 = srcp0[x];
-                    a30 = next1[x - 2]; a31 = next1[x - 1]; a32 = next1[x]; a33 = next1[x + 1]; a34 = next1[x];
-                    a40 = next2[x - 2]; a41 = next2[x - 1]; a42 = next2[x]; a43 = next2[x + 1]; a44 = next2[x];
-                    dstp[x] = detect();
-
-                    x = width - 1;
-                    a00 = prev2[x - 2]; a01 = prev2[x - 1]; a02 = prev2[x]; a03 = prev2[x - 1]; a04 = prev2[x - 2];
-                    a10 = prev1[x - 2]; a11 = prev1[x - 1]; a12 = prev1[x]; a13 = prev1[x - 1]; a14 = prev1[x - 2];
-                    a20 = srcp0[x - 2]; a21 = srcp0[x - 1]; a22 = srcp0[x]; a23 = srcp0[x - 1]; a24 = srcp0[x - 2];
-                    a30 = next1[x - 2]; a31 = next1[x - 1]; a32 = next1[x]; a33 = next1[x - 1]; a34 = next1[x - 2];
-                    a40 = next2[x - 2]; a41 = next2[x - 1]; a42 = next2[x]; a43 = next2[x - 1]; a44 = next2[x - 2];
-                    dstp[x] = detect();
-                }
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard guard(lock);
+        stop = true;
+    }
 
-                srcp0 += stride;
-                dstp += stride;
-            }
+    pending.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void ThreadPool::run(int count, const std::function<void(int)>& task) {
+    Batch batch{ &task, count, 0, 0 };
+    std::unique_lock guard(lock);
+
+    queue.push_back(&batch);
+    pending.notify_all();
+
+    while (batch.next < batch.count) {
+        const int index = batch.next++;
+
+        if (batch.next == batch.count)
+            queue.erase(std::find(queue.begin(), queue.end(), &batch));
+
+        guard.unlock();
+        task(index);
+        guard.lock();
+
+        ++batch.done;
+    }
+
+    finished.wait(guard, [&] { return batch.done == batch.count; });
+}
+
+Tracer::Tracer() : epoch(steadyNow()), ids(0) {
+    if (const char* name = std::getenv("EDGEMASKS_TRACE"))
+        path = name;
+}
+
+Tracer::~Tracer() {
+    if (!enabled())
+        return;
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return;
+
+    std::fprintf(file, "{\"traceEvents\": [");
+    bool first = true;
+
+    for (const auto& buffer : buffers) {
+        for (const auto& event : buffer->events) {
+            std::fprintf(file, "%s\n  {\"name\": \"%s\", \"cat\": \"edgemasks\", \"ph\": \"%c\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, ", first ? "" : ",",
+                         event.name, event.phase, buffer->tid, (event.ts - epoch) / 1000.0);
+
+            if (event.phase == 'X')
+                std::fprintf(file, "\"dur\": %.3f, ", event.dur / 1000.0);
+            else
+                std::fprintf(file, "\"id\": %lld, ", static_cast<long long>(event.id));
+
+            std::fprintf(file, "\"args\": {\"filter\": \"%s\", \"frame\": %d, \"plane\": %d, \"top\": %d, \"bottom\": %d}}", event.filter, event.n,
+                         event.plane, event.top, event.bottom);
+            first = false;
         }
     }
+
+    std::fprintf(file, "\n]}\n");
+    std::fclose(file);
 }
 
-template<typename pixel_t>
-static auto selectC(const std::string& filterName) noexcept {
-    if (filterName == "Tritical")
-        return filterC<pixel_t, Tritical, true>;
-    else if (filterName == "Cross")
-        return filterC<pixel_t, Cross, true>;
-    else if (filterName == "Prewitt")
-        return filterC<pixel_t, Prewitt, true>;
-    else if (filterName == "Sobel")
-        return filterC<pixel_t, Sobel, true>;
-    else if (filterName == "Scharr")
-        return filterC<pixel_t, Scharr, true>;
-    else if (filterName == "RScharr")
-        return filterC<pixel_t, RScharr, true>;
-    else if (filterName == "Kroon")
-        return filterC<pixel_t, Kroon, true>;
-    else if (filterName == "Robinson3")
-        return filterC<pixel_t, Robinson3, false>;
-    else if (filterName == "Robinson5")
-        return filterC<pixel_t, Robinson5, false>;
-    else if (filterName == "Kirsch")
-        return filterC<pixel_t, Kirsch, false>;
-    else if (filterName == "ExPrewitt")
-        return filterC<pixel_t, ExPrewitt, true>;
-    else if (filterName == "ExSobel")
-        return filterC<pixel_t, ExSobel, true>;
-    else if (filterName == "FDoG")
-        return filterC<pixel_t, FDoG, true>;
-    else
-        return filterC<pixel_t, ExKirsch, false>;
+void Tracer::record(const Event& event) noexcept {
+    thread_local Buffer* buffer = nullptr;
+
+    try {
+        if (!buffer) {
+            std::lock_guard guard(lock);
+            buffers.push_back(std::make_unique<Buffer>(Buffer{ static_cast<int>(buffers.size()), {} }));
+            buffer = buffers.back().get();
+            buffer->events.reserve(4096);
+        }
+
+        buffer->events.push_back(event);
+    } catch (...) {
+        // a trace missing events beats a filter failing frames over it
+    }
 }
 
-#ifdef EDGEMASKS_X86
-template<typename pixel_t>
-static auto selectSSE4(const std::string& filterName) noexcept {
-    if (filterName == "Tritical")
-        return filterSSE4<pixel_t, Tritical, true>;
-    else if (filterName == "Cross")
-        return filterSSE4<pixel_t, Cross, true>;
-    else if (filterName == "Prewitt")
-        return filterSSE4<pixel_t, Prewitt, true>;
-    else if (filterName == "Sobel")
-        return filterSSE4<pixel_t, Sobel, true>;
-    else if (filterName == "Scharr")
-        return filterSSE4<pixel_t, Scharr, true>;
-    else if (filterName == "RScharr")
-        return filterSSE4<pixel_t, RScharr, true>;
-    else if (filterName == "Kroon")
-        return filterSSE4<pixel_t, Kroon, true>;
-    else if (filterName == "Robinson3")
-        return filterSSE4<pixel_t, Robinson3, false>;
-    else if (filterName == "Robinson5")
-        return filterSSE4<pixel_t, Robinson5, false>;
-    else if (filterName == "Kirsch")
-        return filterSSE4<pixel_t, Kirsch, false>;
-    else if (filterName == "ExPrewitt")
-        return filterSSE4<pixel_t, ExPrewitt, true>;
-    else if (filterName == "ExSobel")
-        return filterSSE4<pixel_t, ExSobel, true>;
-    else if (filterName == "FDoG")
-        return filterSSE4<pixel_t, FDoG, true>;
-    else
-        return filterSSE4<pixel_t, ExKirsch, false>;
+static Tracer tracer;
+
+// Cycles, instructions and last level cache misses of the calling thread, as a perf_event_open group in user space. Each thread opens its own
+// group on first use and keeps it until it exits; where perf events are unavailable, read() always fails.
+class PerfCounters final {
+public:
+    PerfCounters() noexcept {
+#ifdef __linux__
+        const uint64_t configs[] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES };
+
+        for (int i = 0; i < 3; i++) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.disabled = i == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+
+            if (fds[i] < 0) {
+                close();
+                return;
+            }
+        }
+
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    ~PerfCounters() {
+        close();
+    }
+
+    bool read(uint64_t (&values)[3]) noexcept {
+#ifdef __linux__
+        uint64_t group[4];
+
+        if (fds[0] < 0 || ::read(fds[0], group, sizeof(group)) != sizeof(group))
+            return false;
+
+        std::copy_n(group + 1, 3, values);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    void close() noexcept {
+#ifdef __linux__
+        for (auto& fd : fds) {
+            if (fd >= 0)
+                ::close(fd);
+
+            fd = -1;
+        }
+#endif
+    }
+
+    int fds[3] = { -1, -1, -1 };
+};
+
+static PerfCounters& threadCounters() noexcept {
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+// Indexed by Operator
+static const char* operators[] = {
+    "Tritical", "Cross", "Prewitt", "Sobel", "Scharr", "RScharr", "Kroon", "Robinson3", "Robinson5", "Kirsch", "ExPrewitt", "ExSobel", "FDoG", "ExKirsch"
+};
+
+// Live filter instances in order of creation, for edgemasks.Stats
+static std::mutex instancesLock;
+static std::vector<EdgeMasksData*> instances;
+
+static uint8_t* getBuffer(EdgeMasksData* d) noexcept {
+    const auto threadId = std::this_thread::get_id();
+
+    {
+        std::shared_lock lock(d->bufferLock);
+
+        if (auto it = d->buffer.find(threadId); it != d->buffer.end())
+            return it->second;
+    }
+
+    auto buffer = vsh::vsh_aligned_malloc<uint8_t>(d->bufferSize, 64);
+
+    if (buffer) {
+        std::unique_lock lock(d->bufferLock);
+        d->buffer.emplace(threadId, buffer);
+    }
+
+    return buffer;
 }
 
-template<typename pixel_t>
-static auto selectAVX2(const std::string& filterName) noexcept {
-    if (filterName == "Tritical")
-        return filterAVX2<pixel_t, Tritical, true>;
-    else if (filterName == "Cross")
-        return filterAVX2<pixel_t, Cross, true>;
-    else if (filterName == "Prewitt")
-        return filterAVX2<pixel_t, Prewitt, true>;
-    else if (filterName == "Sobel")
-        return filterAVX2<pixel_t, Sobel, true>;
-    else if (filterName == "Scharr")
-        return filterAVX2<pixel_t, Scharr, true>;
-    else if (filterName == "RScharr")
-        return filterAVX2<pixel_t, RScharr, true>;
-    else if (filterName == "Kroon")
-        return filterAVX2<pixel_t, Kroon, true>;
-    else if (filterName == "Robinson3")
-        return filterAVX2<pixel_t, Robinson3, false>;
-    else if (filterName == "Robinson5")
-        return filterAVX2<pixel_t, Robinson5, false>;
-    else if (filterName == "Kirsch")
-        return filterAVX2<pixel_t, Kirsch, false>;
-    else if (filterName == "ExPrewitt")
-        return filterAVX2<pixel_t, ExPrewitt, true>;
-    else if (filterName == "ExSobel")
-        return filterAVX2<pixel_t, ExSobel, true>;
-    else if (filterName == "FDoG")
-        return filterAVX2<pixel_t, FDoG, true>;
-    else
-        return filterAVX2<pixel_t, ExKirsch, false>;
+// A hysteresis queue of the free list, or a new one if all of them are in use
+static uint8_t* takeQueue(EdgeMasksData* d) noexcept {
+    {
+        std::lock_guard guard(d->queueLock);
+
+        if (!d->queues.empty()) {
+            auto queue = d->queues.back();
+            d->queues.pop_back();
+            return queue;
+        }
+    }
+
+    return vsh::vsh_aligned_malloc<uint8_t>(d->queueSize, 64);
 }
 
-template<typename pixel_t>
-static auto selectAVX512(const std::string& filterName) noexcept {
-    if (filterName == "Tritical")
-        return filterAVX512<pixel_t, Tritical, true>;
-    else if (filterName == "Cross")
-        return filterAVX512<pixel_t, Cross, true>;
-    else if (filterName == "Prewitt")
-        return filterAVX512<pixel_t, Prewitt, true>;
-    else if (filterName == "Sobel")
-        return filterAVX512<pixel_t, Sobel, true>;
-    else if (filterName == "Scharr")
-        return filterAVX512<pixel_t, Scharr, true>;
-    else if (filterName == "RScharr")
-        return filterAVX512<pixel_t, RScharr, true>;
-    else if (filterName == "Kroon")
-        return filterAVX512<pixel_t, Kroon, true>;
-    else if (filterName == "Robinson3")
-        return filterAVX512<pixel_t, Robinson3, false>;
-    else if (filterName == "Robinson5")
-        return filterAVX512<pixel_t, Robinson5, false>;
-    else if (filterName == "Kirsch")
-        return filterAVX512<pixel_t, Kirsch, false>;
-    else if (filterName == "ExPrewitt")
-        return filterAVX512<pixel_t, ExPrewitt, true>;
-    else if (filterName == "ExSobel")
-        return filterAVX512<pixel_t, ExSobel, true>;
-    else if (filterName == "FDoG")
-        return filterAVX512<pixel_t, FDoG, true>;
-    else
-        return filterAVX512<pixel_t, ExKirsch, false>;
+static void returnQueue(EdgeMasksData* d, uint8_t* queue) noexcept {
+    std::lock_guard guard(d->queueLock);
+
+    try {
+        d->queues.push_back(queue);
+    } catch (const std::bad_alloc&) {
+        vsh::vsh_aligned_free(queue);
+    }
 }
+
+// Times the kernels this cpu can run on a synthetic plane of the clip's format and the size of its first processed plane, and returns the opt of the
+// fastest. The result only depends on the cpu, on what selects the kernel and on the size, whose width decides the strips and the tail of the rows,
+// so every operator, magnitude, presmooth, format and plane size is measured once per process.
+static int fastestOpt(EdgeMasksData* d, int magnitude, VSCore* core, const VSAPI* vsapi) {
+    std::vector<std::pair<int, kernel_t>> candidates{ { 5, selectKernel(d->op, magnitude, d->vi->format.bytesPerSample, d->vi->format.bitsPerSample, 5) } };
+
+#ifdef EDGEMASKS_X86
+    const int iset = instrset_detect();
+
+    if (iset >= 5)
+        candidates.emplace_back(2, selectKernel(d->op, magnitude, d->vi->format.bytesPerSample, d->vi->format.bitsPerSample, 2));
+
+    if (iset >= 8)
+        candidates.emplace_back(3, selectKernel(d->op, magnitude, d->vi->format.bytesPerSample, d->vi->format.bitsPerSample, 3));
+
+    if (iset >= 10)
+        candidates.emplace_back(4, selectKernel(d->op, magnitude, d->vi->format.bytesPerSample, d->vi->format.bitsPerSample, 4));
 #endif
 
+    static std::mutex lock;
+    static std::unordered_map<std::string, int> fastest;
+
+    // subsampled chroma, when only chroma is processed, is narrower than the clip
+    int plane = static_cast<int>(std::find(d->process, d->process + 3, true) - d->process);
+    if (plane == 3)
+        plane = 0;
+
+    const int width = d->vi->width >> (plane > 0 ? d->vi->format.subSamplingW : 0);
+    const int height = d->vi->height >> (plane > 0 ? d->vi->format.subSamplingH : 0);
+
+    const auto key = d->filterName + '/' + std::to_string(magnitude) + '/' + std::to_string(d->planes[plane].presmooth) + '/' +
+                     std::to_string(d->vi->format.sampleType) + '/' + std::to_string(d->vi->format.bitsPerSample) + '/' + std::to_string(width) + 'x' +
+                     std::to_string(height);
+
+    // filters created concurrently wait for each other rather than time their kernels against one another
+    std::lock_guard guard(lock);
+
+    auto it = fastest.find(key);
+
+    if (it == fastest.end()) {
+        const int rows = std::min(height, 64);
+        constexpr int rounds = 5;
+        constexpr int calls = 4;
+
+        auto buffer = getBuffer(d);
+        if (!buffer)
+            throw "malloc failure (buffer)"s;
+
+        EdgeMasksPlane p = d->planes[plane];
+        p.srcStride = p.dstStride = (width * d->vi->format.bytesPerSample + 63) & ~63;
+        p.width = width;
+        p.height = rows;
+
+        auto srcp0 = vsh::vsh_aligned_malloc<uint8_t>(p.srcStride * rows, 64);
+        auto dstp0 = vsh::vsh_aligned_malloc<uint8_t>(p.dstStride * rows, 64);
+        p.srcp = srcp0;
+        p.dstp = dstp0;
+        // gx and gy of Signed overwrite each other, which makes no difference to the timing
+        p.dstpGy = dstp0;
+
+        if (!srcp0 || !dstp0) {
+            vsh::vsh_aligned_free(srcp0);
+            vsh::vsh_aligned_free(dstp0);
+            throw "malloc failure (timing planes)"s;
+        }
+
+        auto fill = [&](auto* srcp) noexcept {
+            const ptrdiff_t stride = p.srcStride / sizeof(*srcp);
+            std::minstd_rand generator;
+
+            for (int y = 0; y < rows; y++) {
+                for (int x = 0; x < width; x++) {
+                    if constexpr (std::is_integral_v<std::remove_reference_t<decltype(*srcp)>>)
+                        srcp[x] = std::uniform_int_distribution(0, p.peak)(generator);
+                    else
+                        srcp[x] = std::uniform_real_distribution(0.0f, 1.0f)(generator);
+                }
+
+                srcp += stride;
+            }
+        };
+
+        if (d->vi->format.bytesPerSample == 1)
+            fill(srcp0);
+        else if (d->vi->format.bytesPerSample == 2)
+            fill(reinterpret_cast<uint16_t*>(srcp0));
+        else
+            fill(reinterpret_cast<float*>(srcp0));
+
+        // rounds alternate between the kernels, so that a change of clock speed halfway through does not favour one of them
+        std::vector<double> best(candidates.size(), std::numeric_limits<double>::max());
+
+        for (int round = 0; round < rounds; round++) {
+            for (size_t i = 0; i < candidates.size(); i++) {
+                const auto start = std::chrono::steady_clock::now();
+
+                for (int n = 0; n < calls; n++)
+                    candidates[i].second(&p, 0, rows, buffer);
+
+                best[i] = std::min(best[i], std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+        }
+
+        vsh::vsh_aligned_free(srcp0);
+        vsh::vsh_aligned_free(dstp0);
+
+        it = fastest.emplace(key, candidates[std::min_element(best.begin(), best.end()) - best.begin()].first).first;
+    }
+
+    vsapi->logMessage(mtInformation, (d->filterName + ": opt=6 selected " + isaName(it->second)).c_str(), core);
+
+    return it->second;
+}
+
+// Fills a plane with a gradient of zero as the Signed output holds it, half the range for integer samples
+static void fillZeroGradient(VSFrame* frame, int plane, const VSVideoFormat& format, const VSAPI* vsapi) noexcept {
+    const int width = vsapi->getFrameWidth(frame, plane);
+    const int height = vsapi->getFrameHeight(frame, plane);
+    const ptrdiff_t stride = vsapi->getStride(frame, plane);
+    uint8_t* dstp = vsapi->getWritePtr(frame, plane);
+
+    for (int y = 0; y < height; y++) {
+        if (format.bytesPerSample == 1)
+            std::memset(dstp, 1 << (format.bitsPerSample - 1), width);
+        else if (format.bytesPerSample == 2)
+            std::fill_n(reinterpret_cast<uint16_t*>(dstp), width, 1 << (format.bitsPerSample - 1));
+        else
+            std::fill_n(reinterpret_cast<float*>(dstp), width, 0.0f);
+
+        dstp += stride;
+    }
+}
+
 static const VSFrame* VS_CC edgemasksGetFrame(int n, int activationReason, void* instanceData, [[maybe_unused]] void** frameData, VSFrameContext* frameCtx,
                                               VSCore* core, const VSAPI* vsapi) {
-    auto d = static_cast<const EdgeMasksData*>(instanceData);
+    auto d = static_cast<EdgeMasksData*>(instanceData);
 
     if (activationReason == arInitial) {
         vsapi->requestFrameFilter(n, d->node, frameCtx);
     } else if (activationReason == arAllFramesReady) {
         const VSFrame* src = vsapi->getFrameFilter(n, d->node, frameCtx);
-        const VSFrame* fr[] = { d->process[0] ? nullptr : src, d->process[1] ? nullptr : src, d->process[2] ? nullptr : src };
-        const int pl[] = { 0, 1, 2 };
-        VSFrame* dst = vsapi->newVideoFrame2(&d->vi->format, d->vi->width, d->vi->height, fr, pl, src, core);
+        VSFrame* dst;
+
+        if (d->signedOutput) {
+            dst = vsapi->newVideoFrame(&d->outVi.format, d->outVi.width, d->outVi.height, src, core);
+            fillZeroGradient(dst, 2, d->outVi.format, vsapi);
+        } else {
+            const VSFrame* fr[] = { d->process[0] ? nullptr : src, d->process[1] ? nullptr : src, d->process[2] ? nullptr : src };
+            const int pl[] = { 0, 1, 2 };
+            dst = vsapi->newVideoFrame2(&d->vi->format, d->vi->width, d->vi->height, fr, pl, src, core);
+        }
+
+        std::atomic<bool> failed = false, queueFailed = false;
+        std::atomic<int64_t> planeTime[3] = {}, planeBegin[3] = {}, planeEnd[3] = {};
+        const bool tracing = tracer.enabled();
+        const int64_t start = steadyNow();
 
-        d->filter(src, dst, d, vsapi);
+        Tracer::Event event{ 'X', "frame", d->staticName, n, -1, 0, 0, 0, start, 0 };
 
-        vsapi->mapSetInt(vsapi->getFramePropertiesRW(dst), "_ColorRange", 0, maReplace);
+        EdgeMasksPlane planes[3];
+        int64_t area[3] = {}, total = 0;
+
+        for (int plane = 0; plane < d->vi->format.numPlanes; plane++) {
+            if (d->process[plane]) {
+                planes[plane] = d->planes[plane];
+                planes[plane].srcp = vsapi->getReadPtr(src, plane);
+                planes[plane].dstp = vsapi->getWritePtr(dst, d->signedOutput ? 0 : plane);
+                planes[plane].srcStride = vsapi->getStride(src, plane);
+                planes[plane].dstStride = vsapi->getStride(dst, d->signedOutput ? 0 : plane);
+
+                if (d->signedOutput)
+                    planes[plane].dstpGy = vsapi->getWritePtr(dst, 1);
+
+                planes[plane].width = vsapi->getFrameWidth(src, plane);
+                planes[plane].height = vsapi->getFrameHeight(src, plane);
+
+                area[plane] = static_cast<int64_t>(planes[plane].width) * planes[plane].height;
+                total += area[plane];
+            }
+        }
+
+        // all processed planes go into one batch, each cut into a share of the threads proportional to its size, so subsampled chroma
+        // does not leave threads idle behind the luma and planes of equal size run side by side. each band primes its ring from the rows
+        // around it, so band boundaries need no special handling
+        int bands[3] = {}, first[4] = {};
+        for (int plane = 0; plane < 3; plane++) {
+            if (area[plane])
+                bands[plane] = std::clamp(static_cast<int>((d->threads * area[plane] + total - 1) / total), 1, std::max(planes[plane].height / 16, 1));
+
+            first[plane + 1] = first[plane] + bands[plane];
+        }
+
+        auto band = [&](int i) {
+            uint8_t* buffer = getBuffer(d);
+
+            if (!buffer) {
+                failed = true;
+                return;
+            }
+
+            const int plane = i < first[1] ? 0 : (i < first[2] ? 1 : 2);
+            const int height = planes[plane].height;
+            i -= first[plane];
+
+            const int top = height * i / bands[plane];
+            const int bottom = height * (i + 1) / bands[plane];
+
+            if (!d->profile && !tracing && !d->counters) {
+                d->filter(&planes[plane], top, bottom, buffer);
+                return;
+            }
+
+            uint64_t before[3], after[3];
+            const bool counted = d->counters && threadCounters().read(before);
+
+            const int64_t bandBegin = steadyNow();
+            d->filter(&planes[plane], top, bottom, buffer);
+            const int64_t bandEnd = steadyNow();
+
+            if (counted && threadCounters().read(after)) {
+                d->cycles.fetch_add(after[0] - before[0], std::memory_order_relaxed);
+                d->instructions.fetch_add(after[1] - before[1], std::memory_order_relaxed);
+                d->cacheMisses.fetch_add(after[2] - before[2], std::memory_order_relaxed);
+            }
+
+            planeTime[plane] += bandEnd - bandBegin;
+
+            if (tracing) {
+                Tracer::Event bandEvent = event;
+                bandEvent.name = "band";
+                bandEvent.plane = plane;
+                bandEvent.top = top;
+                bandEvent.bottom = bottom;
+                bandEvent.ts = bandBegin;
+                bandEvent.dur = bandEnd - bandBegin;
+                tracer.record(bandEvent);
+
+                // a plane spans from its first band starting to its last band finishing, whichever threads ran them
+                for (int64_t begin = planeBegin[plane]; (!begin || bandBegin < begin) && !planeBegin[plane].compare_exchange_weak(begin, bandBegin);)
+                    ;
+                for (int64_t end = planeEnd[plane]; bandEnd > end && !planeEnd[plane].compare_exchange_weak(end, bandEnd);)
+                    ;
+            }
+        };
+
+        if (first[3] > 1 && d->pool) {
+            d->pool->run(first[3], band);
+        } else {
+            for (int i = 0; i < first[3]; i++)
+                band(i);
+        }
+
+        // hysteresis follows edges across the bands, so it runs on whole planes once all bands are done, the planes side by side
+        if (d->hysteresis && !failed) {
+            int linked[3], count = 0;
+            for (int plane = 0; plane < 3; plane++) {
+                if (area[plane])
+                    linked[count++] = plane;
+            }
+
+            auto link = [&](int i) {
+                const int plane = linked[i];
+
+                auto queue = takeQueue(d);
+
+                if (!queue) {
+                    queueFailed = true;
+                    return;
+                }
+
+                if (!d->profile && !tracing) {
+                    d->hysteresis(&planes[plane], queue);
+                    returnQueue(d, queue);
+                    return;
+                }
+
+                const int64_t linkBegin = steadyNow();
+                d->hysteresis(&planes[plane], queue);
+                const int64_t linkEnd = steadyNow();
+                returnQueue(d, queue);
+
+                planeTime[plane] += linkEnd - linkBegin;
+
+                if (tracing) {
+                    Tracer::Event linkEvent = event;
+                    linkEvent.name = "hysteresis";
+                    linkEvent.plane = plane;
+                    linkEvent.bottom = planes[plane].height;
+                    linkEvent.ts = linkBegin;
+                    linkEvent.dur = linkEnd - linkBegin;
+                    tracer.record(linkEvent);
+
+                    planeEnd[plane] = linkEnd;
+                }
+            };
+
+            if (count > 1 && d->pool) {
+                d->pool->run(count, link);
+            } else {
+                for (int i = 0; i < count; i++)
+                    link(i);
+            }
+        }
+
+        if (failed || queueFailed) {
+            vsapi->setFilterError((d->filterName + (failed ? ": malloc failure (buffer)" : ": malloc failure (hysteresis queue)")).c_str(), frameCtx);
+            vsapi->freeFrame(src);
+            vsapi->freeFrame(dst);
+            return nullptr;
+        }
+
+        const int64_t elapsed = steadyNow() - start;
+
+        if (tracing) {
+            event.dur = elapsed;
+            tracer.record(event);
+
+            // planes overlap in time, so they are async events rather than slices of one thread
+            for (int plane = 0; plane < 3; plane++) {
+                if (area[plane]) {
+                    Tracer::Event planeEvent = event;
+                    planeEvent.phase = 'b';
+                    planeEvent.name = "plane";
+                    planeEvent.plane = plane;
+                    planeEvent.id = tracer.nextId();
+                    planeEvent.ts = planeBegin[plane];
+                    tracer.record(planeEvent);
+
+                    planeEvent.phase = 'e';
+                    planeEvent.ts = planeEnd[plane];
+                    tracer.record(planeEvent);
+                }
+            }
+        }
+
+        d->frames.fetch_add(1, std::memory_order_relaxed);
+        d->pixels.fetch_add(total, std::memory_order_relaxed);
+        d->nanoseconds.fetch_add(elapsed, std::memory_order_relaxed);
+
+        VSMap* props = vsapi->getFramePropertiesRW(dst);
+        vsapi->mapSetInt(props, "_ColorRange", 0, maReplace);
+
+        // gx and gy are not colour, so nothing downstream should convert them as if they were
+        if (d->signedOutput) {
+            for (const char* key : { "_Matrix", "_Primaries", "_Transfer", "_ChromaLocation" })
+                vsapi->mapDeleteKey(props, key);
+        }
+
+        if (d->profile) {
+            // wall time of the whole frame, and per plane the time its bands spent in the kernel summed over the threads that ran them
+            const int64_t planeTimes[] = { planeTime[0], planeTime[1], planeTime[2] };
+            vsapi->mapSetInt(props, "_EdgeMasksTimeNs", elapsed, maReplace);
+            vsapi->mapSetIntArray(props, "_EdgeMasksPlaneTimeNs", planeTimes, d->vi->format.numPlanes);
+        }
 
         vsapi->freeFrame(src);
         return dst;
@@ -382,8 +646,21 @@ static const VSFrame* VS_CC edgemasksGetFrame(int n, int activationReason, void*
     return nullptr;
 }
 
+
 static void VS_CC edgemasksFree(void* instanceData, [[maybe_unused]] VSCore* core, const VSAPI* vsapi) {
     auto d = static_cast<EdgeMasksData*>(instanceData);
+
+    {
+        std::lock_guard guard(instancesLock);
+        instances.erase(std::find(instances.begin(), instances.end(), d));
+    }
+
+    for (auto& iter : d->buffer)
+        vsh::vsh_aligned_free(iter.second);
+
+    for (auto queue : d->queues)
+        vsh::vsh_aligned_free(queue);
+
     vsapi->freeNode(d->node);
     delete d;
 }
@@ -391,11 +668,14 @@ static void VS_CC edgemasksFree(void* instanceData, [[maybe_unused]] VSCore* cor
 static void VS_CC edgemasksCreate(const VSMap* in, VSMap* out, void* userData, VSCore* core, const VSAPI* vsapi) {
     auto d = std::make_unique<EdgeMasksData>();
 
-    d->filterName = static_cast<const char*>(userData);
+    d->filterName = d->staticName = static_cast<const char*>(userData);
+    d->op = static_cast<int>(std::find(std::begin(operators), std::end(operators), userData) - std::begin(operators));
+    const bool canny = d->filterName == "Canny";
 
     try {
         d->node = vsapi->mapGetNode(in, "clip", 0, nullptr);
         d->vi = vsapi->getVideoInfo(d->node);
+        d->outVi = *d->vi;
         int err;
 
         if (!vsh::isConstantVideoFormat(d->vi) ||
@@ -403,10 +683,21 @@ static void VS_CC edgemasksCreate(const VSMap* in, VSMap* out, void* userData, V
             (d->vi->format.sampleType == stFloat && d->vi->format.bitsPerSample != 32))
             throw "only constant format 8-16 bit integer and 32 bit float input supported"s;
 
+        int magnitude = vsapi->mapGetIntSaturated(in, "magnitude", 0, &err);
+
+        if (magnitude < 0 || magnitude > (canny ? 3 : 4))
+            throw canny ? "magnitude must be 0, 1, 2, or 3"s : "magnitude must be 0, 1, 2, 3, or 4"s;
+
+        d->signedOutput = magnitude == 4;
+
         const int m = vsapi->mapNumElements(in, "planes");
 
+        if (d->signedOutput && m > 1)
+            throw "magnitude=4 processes a single plane"s;
+
+        // Signed defaults to the first plane only
         for (int i = 0; i < 3; i++)
-            d->process[i] = (m <= 0);
+            d->process[i] = (m <= 0) && (!d->signedOutput || i == 0);
 
         for (int i = 0; i < m; i++) {
             const int n = vsapi->mapGetIntSaturated(in, "planes", i, nullptr);
@@ -424,20 +715,64 @@ static void VS_CC edgemasksCreate(const VSMap* in, VSMap* out, void* userData, V
             throw "scale has more values specified than there are planes"s;
 
         for (int plane = 0; plane < d->vi->format.numPlanes; plane++) {
-            d->scale[plane] = vsapi->mapGetFloatSaturated(in, "scale", plane, &err);
+            d->planes[plane].scale = vsapi->mapGetFloatSaturated(in, "scale", plane, &err);
 
             if (err) {
                 if (plane == 0)
-                    d->scale[plane] = 1.0f;
+                    d->planes[plane].scale = 1.0f;
                 else
-                    d->scale[plane] = d->scale[plane - 1];
+                    d->planes[plane].scale = d->planes[plane - 1].scale;
             } else {
-                if (d->scale[plane] <= 0.0f)
+                if (d->planes[plane].scale <= 0.0f)
                     throw "scale must be greater than 0.0"s;
             }
         }
 
-        const int opt = vsapi->mapGetIntSaturated(in, "opt", 0, &err);
+        if (vsapi->mapNumElements(in, "thr_lo") > d->vi->format.numPlanes)
+            throw "thr_lo has more values specified than there are planes"s;
+
+        if (vsapi->mapNumElements(in, "thr_hi") > d->vi->format.numPlanes)
+            throw "thr_hi has more values specified than there are planes"s;
+
+        if (d->signedOutput && (vsapi->mapNumElements(in, "thr_lo") > 0 || vsapi->mapNumElements(in, "thr_hi") > 0))
+            throw "thr_lo and thr_hi are not available with magnitude=4"s;
+
+        float thrLo[3], thrHi[3];
+
+        // Canny always thresholds, by default at a fifth and a tenth of the peak
+        const float peak = d->vi->format.sampleType == stInteger ? (1 << d->vi->format.bitsPerSample) - 1 : 1.0f;
+
+        for (int plane = 0; plane < d->vi->format.numPlanes; plane++) {
+            thrHi[plane] = vsapi->mapGetFloatSaturated(in, "thr_hi", plane, &err);
+            if (err)
+                thrHi[plane] = plane == 0 ? (canny ? peak * 0.2f : std::numeric_limits<float>::infinity()) : thrHi[plane - 1];
+
+            thrLo[plane] = vsapi->mapGetFloatSaturated(in, "thr_lo", plane, &err);
+            if (err)
+                thrLo[plane] = plane == 0 ? (canny ? std::min(peak * 0.1f, thrHi[plane]) : 0.0f) : thrLo[plane - 1];
+
+            if (thrLo[plane] < 0.0f)
+                throw "thr_lo must be greater than or equal to 0.0"s;
+
+            if (thrHi[plane] < thrLo[plane])
+                throw "thr_hi must be greater than or equal to thr_lo"s;
+        }
+
+        const int direction = vsapi->mapGetIntSaturated(in, "direction", 0, &err);
+
+        const int presmooth = vsapi->mapGetIntSaturated(in, "presmooth", 0, &err);
+
+        const int gradient = vsapi->mapGetIntSaturated(in, "gradient", 0, &err);
+
+        int opt = vsapi->mapGetIntSaturated(in, "opt", 0, &err);
+
+        d->threads = vsapi->mapGetIntSaturated(in, "threads", 0, &err);
+        if (err)
+            d->threads = 1;
+
+        d->profile = !!vsapi->mapGetInt(in, "profile", 0, &err);
+
+        d->counters = !!vsapi->mapGetInt(in, "counters", 0, &err);
 
         if (d->filterName == "ExPrewitt" || d->filterName == "ExSobel" || d->filterName == "FDoG" || d->filterName == "ExKirsch")
             d->matrix = 5;
@@ -454,74 +789,133 @@ static void VS_CC edgemasksCreate(const VSMap* in, VSMap* out, void* userData, V
             }
         }
 
-        if (opt < 0 || opt > 4)
-            throw "opt must be 0, 1, 2, 3, or 4"s;
+        if (gradient < 0 || gradient > 1)
+            throw "gradient must be 0 or 1"s;
 
-        for (int plane = 0; plane < d->vi->format.numPlanes; plane++) {
-            if (d->filterName == "Scharr")
-                d->scale[plane] /= 3;
-            else if (d->filterName == "RScharr")
-                d->scale[plane] /= 47;
-            else if (d->filterName == "Kroon")
-                d->scale[plane] /= 17;
-            else if (d->filterName == "FDoG")
-                d->scale[plane] /= 2;
+        if (direction != 0 && direction != 1 && direction != 8 && direction != 16)
+            throw "direction must be 0, 1, 8, or 16"s;
+
+        if (direction && isCompass(d->op))
+            throw "direction is not available for the compass operators"s;
+
+        if (direction == 1 && d->vi->format.sampleType != stFloat)
+            throw "direction=1 requires float input"s;
+
+        if (direction && d->signedOutput)
+            throw "direction is not available with magnitude=4"s;
+
+        if (d->signedOutput && isCompass(d->op))
+            throw "magnitude=4 is not available for the compass operators"s;
+
+        if (presmooth < 0 || presmooth > 2)
+            throw "presmooth must be 0, 1, or 2"s;
+
+        // gx and gy go to the first two planes of a YUV444 clip the size of the plane they come from, the third holding a gradient of zero
+        if (d->signedOutput) {
+            const int plane = static_cast<int>(std::find(d->process, d->process + 3, true) - d->process);
+            magnitude = Signed;
+
+            if (!vsapi->queryVideoFormat(&d->outVi.format, cfYUV, d->vi->format.sampleType, d->vi->format.bitsPerSample, 0, 0, core))
+                throw "failed to query the output format"s;
+
+            d->outVi.width = d->vi->width >> (plane > 0 ? d->vi->format.subSamplingW : 0);
+            d->outVi.height = d->vi->height >> (plane > 0 ? d->vi->format.subSamplingH : 0);
         }
 
-        {
-#ifdef EDGEMASKS_X86
-            const int iset = instrset_detect();
-#endif
+        // the direction takes the place of the magnitude in the kernels
+        if (direction) {
+            magnitude = Direction;
 
-            if (d->vi->format.bytesPerSample == 1) {
-                d->filter = selectC<uint8_t>(d->filterName);
+            for (int plane = 0; plane < d->vi->format.numPlanes; plane++)
+                d->planes[plane].bins = direction == 1 ? 0 : direction;
+        }
 
-#ifdef EDGEMASKS_X86
-                if ((opt == 0 && iset >= 10) || opt == 4)
-                    d->filter = selectAVX512<uint8_t>(d->filterName);
-                else if ((opt == 0 && iset >= 8) || opt == 3)
-                    d->filter = selectAVX2<uint8_t>(d->filterName);
-                else if ((opt == 0 && iset >= 5) || opt == 2)
-                    d->filter = selectSSE4<uint8_t>(d->filterName);
-#endif
-            } else if (d->vi->format.bytesPerSample == 2) {
-                d->filter = selectC<uint16_t>(d->filterName);
+        if (canny)
+            d->op = gradient ? Scharr : Sobel;
 
-#ifdef EDGEMASKS_X86
-                if ((opt == 0 && iset >= 10) || opt == 4)
-                    d->filter = selectAVX512<uint16_t>(d->filterName);
-                else if ((opt == 0 && iset >= 8) || opt == 3)
-                    d->filter = selectAVX2<uint16_t>(d->filterName);
-                else if ((opt == 0 && iset >= 5) || opt == 2)
-                    d->filter = selectSSE4<uint16_t>(d->filterName);
-#endif
-            } else {
-                d->filter = selectC<float>(d->filterName);
+        if (opt < 0 || opt > 6)
+            throw "opt must be 0, 1, 2, 3, 4, 5, or 6"s;
 
-#ifdef EDGEMASKS_X86
-                if ((opt == 0 && iset >= 10) || opt == 4)
-                    d->filter = selectAVX512<float>(d->filterName);
-                else if ((opt == 0 && iset >= 8) || opt == 3)
-                    d->filter = selectAVX2<float>(d->filterName);
-                else if ((opt == 0 && iset >= 5) || opt == 2)
-                    d->filter = selectSSE4<float>(d->filterName);
-#endif
-            }
+        if (d->threads < 0)
+            throw "threads must be greater than or equal to 0"s;
+
+        if (d->threads == 0)
+            d->threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+        if (d->threads > 1)
+            d->pool = std::make_unique<ThreadPool>(d->threads - 1);
+
+        d->bufferSize = canny ? cannyBufferSize(d->vi->width) : bufferSize(d->vi->width, d->matrix);
+        d->queueSize = canny ? hysteresisQueueSize(d->vi->width, d->vi->height) : 0;
+
+        for (int plane = 0; plane < d->vi->format.numPlanes; plane++) {
+            d->planes[plane].scale /= operatorNorm(d->op);
+            d->planes[plane].presmooth = presmooth;
+
+            if (d->vi->format.sampleType == stInteger)
+                d->planes[plane].peak = (1 << d->vi->format.bitsPerSample) - 1;
+
+            foldScale(&d->planes[plane], d->op, magnitude);
+            setThresholds(&d->planes[plane], thrLo[plane], thrHi[plane]);
         }
 
-        if (d->vi->format.sampleType == stInteger)
-            d->peak = (1 << d->vi->format.bitsPerSample) - 1;
+        if (opt == 6)
+            opt = fastestOpt(d.get(), magnitude, core, vsapi);
+
+        if (canny) {
+            d->filter = selectCanny(d->op, magnitude, d->vi->format.bytesPerSample);
+            d->hysteresis = selectHysteresis(d->vi->format.bytesPerSample);
+            d->isa = isaName(1);
+        } else {
+            d->filter = selectKernel(d->op, magnitude, d->vi->format.bytesPerSample, d->vi->format.bitsPerSample, opt);
+            d->isa = isaName(opt);
+        }
+
+        if (uint64_t values[3]; d->counters && !threadCounters().read(values)) {
+            vsapi->logMessage(mtWarning, (d->filterName + ": hardware performance counters are unavailable, counters is ignored").c_str(), core);
+            d->counters = false;
+        }
     } catch (const std::string& error) {
         vsapi->mapSetError(out, (d->filterName + ": " + error).c_str());
         vsapi->freeNode(d->node);
         return;
     }
 
+    {
+        std::lock_guard guard(instancesLock);
+        instances.push_back(d.get());
+    }
+
     VSFilterDependency deps[] = { {d->node, rpStrictSpatial} };
-    vsapi->createVideoFilter(out, d->filterName.c_str(), d->vi, edgemasksGetFrame, edgemasksFree, fmParallel, deps, 1, d.get(), core);
+    vsapi->createVideoFilter(out, d->filterName.c_str(), &d->outVi, edgemasksGetFrame, edgemasksFree, fmParallel, deps, 1, d.get(), core);
     d.release();
 }
 
+static void VS_CC edgemasksStats([[maybe_unused]] const VSMap* in, VSMap* out, [[maybe_unused]] void* userData, [[maybe_unused]] VSCore* core,
+                                  const VSAPI* vsapi) {
+    vsapi->mapSetEmpty(out, "filter", ptData);
+    vsapi->mapSetEmpty(out, "isa", ptData);
+    vsapi->mapSetEmpty(out, "frames", ptInt);
+    vsapi->mapSetEmpty(out, "pixels", ptInt);
+    vsapi->mapSetEmpty(out, "nanoseconds", ptInt);
+    vsapi->mapSetEmpty(out, "cycles", ptInt);
+    vsapi->mapSetEmpty(out, "instructions", ptInt);
+    vsapi->mapSetEmpty(out, "cache_misses", ptInt);
+
+    std::lock_guard guard(instancesLock);
+
+    for (auto d : instances) {
+        vsapi->mapSetData(out, "filter", d->filterName.c_str(), -1, dtUtf8, maAppend);
+        vsapi->mapSetData(out, "isa", d->isa.c_str(), -1, dtUtf8, maAppend);
+        vsapi->mapSetInt(out, "frames", d->frames.load(std::memory_order_relaxed), maAppend);
+        vsapi->mapSetInt(out, "pixels", d->pixels.load(std::memory_order_relaxed), maAppend);
+        vsapi->mapSetInt(out, "nanoseconds", d->nanoseconds.load(std::memory_order_relaxed), maAppend);
+        vsapi->mapSetInt(out, "cycles", d->counters ? d->cycles.load(std::memory_order_relaxed) : -1, maAppend);
+        vsapi->mapSetInt(out, "instructions", d->counters ? d->instructions.load(std::memory_order_relaxed) : -1, maAppend);
+        vsapi->mapSetInt(out, "cache_misses", d->counters ? d->cacheMisses.load(std::memory_order_relaxed) : -1, maAppend);
+    }
+}
+
 //////////////////////////////////////////
 // Init
 
@@ -534,15 +928,27 @@ VS_EXTERNAL_API(void) VapourSynthPluginInit2(VSPlugin* plugin, const VSPLUGINAPI
                          0,
                          plugin);
 
-    const char* operators[] = {
-        "Tritical", "Cross", "Prewitt", "Sobel", "Scharr", "RScharr", "Kroon", "Robinson3", "Robinson5", "Kirsch", "ExPrewitt", "ExSobel", "FDoG", "ExKirsch"
-    };
-
     for (int i = 0; i < 14; i++)
         vspapi->registerFunction(operators[i],
-                                 "clip:vnode;planes:int[]:opt;scale:float[]:opt;opt:int:opt;",
+                                 "clip:vnode;planes:int[]:opt;scale:float[]:opt;thr_lo:float[]:opt;thr_hi:float[]:opt;opt:int:opt;magnitude:int:opt;direction:int:opt;"
+                                 "presmooth:int:opt;threads:int:opt;profile:int:opt;counters:int:opt;",
                                  "clip:vnode;",
                                  edgemasksCreate,
                                  const_cast<char*>(operators[i]),
                                  plugin);
+
+    vspapi->registerFunction("Canny",
+                             "clip:vnode;planes:int[]:opt;scale:float[]:opt;thr_lo:float[]:opt;thr_hi:float[]:opt;gradient:int:opt;magnitude:int:opt;threads:int:opt;"
+                             "profile:int:opt;counters:int:opt;",
+                             "clip:vnode;",
+                             edgemasksCreate,
+                             const_cast<char*>("Canny"),
+                             plugin);
+
+    vspapi->registerFunction("Stats",
+                             "",
+                             "filter:data[];isa:data[];frames:int[];pixels:int[];nanoseconds:int[];cycles:int[];instructions:int[];cache_misses:int[];",
+                             edgemasksStats,
+                             nullptr,
+                             plugin);
 }
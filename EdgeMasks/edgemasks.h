@@ -1,38 +1,119 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include <VapourSynth4.h>
 #include <VSHelper4.h>
 
-#ifdef EDGEMASKS_X86
-#include "vectorclass/vectorclass.h"
-#endif
+#include "edgemasks_kernels.h"
+
+// Runs batches of indexed tasks on a fixed set of workers. Batches from concurrent callers are queued, and each caller works on its own batch
+// until every index has been claimed, so run() never waits on a batch it could be executing itself.
+class ThreadPool final {
+public:
+    explicit ThreadPool(int workers);
+    ~ThreadPool();
+
+    void run(int count, const std::function<void(int)>& task);
+
+private:
+    struct Batch {
+        const std::function<void(int)>* task;
+        int count, next, done;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Batch*> queue;
+    std::mutex lock;
+    std::condition_variable pending, finished;
+    bool stop = false;
+};
+
+// Chrome trace of frames, planes and bands, enabled by naming the output file in the EDGEMASKS_TRACE environment variable and written when the
+// process exits. Every thread appends to a buffer of its own, so recording takes no lock.
+class Tracer final {
+public:
+    struct Event {
+        char phase;
+        // static strings, which outlive the instances the events come from until the trace is written at exit
+        const char* name;
+        const char* filter;
+        int n, plane, top, bottom;
+        int64_t id, ts, dur;
+    };
+
+    Tracer();
+    ~Tracer();
+
+    bool enabled() const noexcept {
+        return !path.empty();
+    }
+
+    int64_t nextId() noexcept {
+        return ids++;
+    }
+
+    void record(const Event& event) noexcept;
+
+private:
+    struct Buffer {
+        int tid;
+        std::vector<Event> events;
+    };
+
+    std::string path;
+    int64_t epoch;
+    std::atomic<int64_t> ids;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    std::mutex lock;
+};
+
+// Nanoseconds of the steady clock, the time base of profiling, statistics and traces
+inline int64_t steadyNow() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 struct EdgeMasksData final {
     VSNode* node;
     const VSVideoInfo* vi;
+    // of the output, a YUV444 clip of the processed plane for Signed and the input's format otherwise
+    VSVideoInfo outVi;
     bool process[3];
-    float scale[3];
-    int matrix, peak;
+    // gx and gy of the one processed plane go to the first two planes of the output, instead of a mask to each processed plane
+    bool signedOutput;
+    // everything of the planes but their pointers and sizes, which come with each frame
+    EdgeMasksPlane planes[3];
+    int op, matrix, threads;
+    std::unique_ptr<ThreadPool> pool;
     std::string filterName;
-    void (*filter)(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-};
-
-enum Operator {
-    Tritical,
-    Cross,
-    Prewitt,
-    Sobel,
-    Scharr,
-    RScharr,
-    Kroon,
-    Robinson3,
-    Robinson5,
-    Kirsch,
-    ExPrewitt,
-    ExSobel,
-    FDoG,
-    ExKirsch
+    // the same, as the static string the function is registered with
+    const char* staticName;
+    size_t bufferSize;
+    std::unordered_map<std::thread::id, uint8_t*> buffer;
+    std::shared_mutex bufferLock;
+    kernel_t filter;
+    // second pass of Canny over whole planes, null for the edge masks
+    hysteresis_t hysteresis;
+    // queues of the hysteresis, each with room for every pixel of the largest plane. passes take one from the list and put it back when done,
+    // so the list grows to the most passes that have run at once and is reused by the frames after them
+    size_t queueSize;
+    std::vector<uint8_t*> queues;
+    std::mutex queueLock;
+    bool profile, counters;
+    std::string isa;
+    // totals for edgemasks.Stats, bumped once per frame by whichever thread finished it, and once per band for the hardware counters
+    std::atomic<int64_t> frames, pixels, nanoseconds;
+    std::atomic<int64_t> cycles, instructions, cacheMisses;
 };
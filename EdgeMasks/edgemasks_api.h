@@ -0,0 +1,106 @@
+/*
+    MIT License
+
+    Copyright (c) 2025 HolyWu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* Plane-level C interface to the kernels, for hosts other than VapourSynth */
+
+#ifndef EDGEMASKS_API_H
+#define EDGEMASKS_API_H
+
+#include <stddef.h>
+
+/* exported only from the library built for other hosts; the VapourSynth plugin links the kernels in with the API hidden, and exports nothing
+   but its entry point */
+#if !defined(EDGEMASKS_BUILDING_LIBRARY)
+#define EDGEMASKS_EXPORT
+#elif defined(_WIN32)
+#define EDGEMASKS_EXPORT __declspec(dllexport)
+#else
+#define EDGEMASKS_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* In the order of the plugin's functions */
+typedef enum EdgeMasksOperator {
+    EDGEMASKS_TRITICAL,
+    EDGEMASKS_CROSS,
+    EDGEMASKS_PREWITT,
+    EDGEMASKS_SOBEL,
+    EDGEMASKS_SCHARR,
+    EDGEMASKS_RSCHARR,
+    EDGEMASKS_KROON,
+    EDGEMASKS_ROBINSON3,
+    EDGEMASKS_ROBINSON5,
+    EDGEMASKS_KIRSCH,
+    EDGEMASKS_EXPREWITT,
+    EDGEMASKS_EXSOBEL,
+    EDGEMASKS_FDOG,
+    EDGEMASKS_EXKIRSCH
+} EdgeMasksOperator;
+
+typedef enum EdgeMasksSampleType {
+    EDGEMASKS_UINT8,
+    EDGEMASKS_UINT16,
+    EDGEMASKS_FLOAT
+} EdgeMasksSampleType;
+
+/* As the plugin's opt, without timing */
+typedef enum EdgeMasksIsa {
+    EDGEMASKS_ISA_AUTO,
+    EDGEMASKS_ISA_C,
+    EDGEMASKS_ISA_SSE4,
+    EDGEMASKS_ISA_AVX2,
+    EDGEMASKS_ISA_AVX512,
+    EDGEMASKS_ISA_PORTABLE
+} EdgeMasksIsa;
+
+typedef struct EdgeMasksParams {
+    int bits;      /* bit depth of integer samples, 8 for EDGEMASKS_UINT8 and 9-16 for EDGEMASKS_UINT16; ignored for float */
+    int magnitude; /* as the plugin's magnitude, 0-3 */
+    float scale;   /* as the plugin's scale, greater than 0 */
+    float thr_lo;  /* as the plugin's thr_lo, 0 or greater */
+    float thr_hi;  /* as the plugin's thr_hi, not less than thr_lo; INFINITY of math.h for none */
+    int presmooth; /* as the plugin's presmooth, 0-2 */
+} EdgeMasksParams;
+
+enum {
+    EDGEMASKS_OK = 0,
+    EDGEMASKS_ERROR_ARGUMENT = -1,    /* a parameter out of range, or a plane smaller than the operator or misaligned */
+    EDGEMASKS_ERROR_UNSUPPORTED = -2, /* the cpu lacks the instruction set asked for */
+    EDGEMASKS_ERROR_MEMORY = -3
+};
+
+/* Writes the edge mask of src to dst, which must not overlap. Both planes have to be 64-byte aligned, with strides in bytes that are multiples of
+   64 and cover the width. The output is identical to the plugin's for the same operator, parameters and isa. Safe to call from any number of
+   threads at once. Returns EDGEMASKS_OK or one of the errors. */
+EDGEMASKS_EXPORT int edgemasks_process_plane(EdgeMasksOperator op, EdgeMasksSampleType type, const void* src, ptrdiff_t src_stride, void* dst,
+                                             ptrdiff_t dst_stride, int width, int height, const EdgeMasksParams* params, EdgeMasksIsa isa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1113 @@
+/*
+    MIT License
+
+    Copyright (c) 2025 HolyWu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include "edgemasks_api.h"
+#include "edgemasks_kernels.h"
+
+template<typename pixel_t, int Operator, int Magnitude, int Bits>
+extern void filterPortable(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+
+#ifdef EDGEMASKS_X86
+template<typename pixel_t, int Operator, int Magnitude, int Bits>
+extern void filterSSE4(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+
+template<typename pixel_t, int Operator, int Magnitude, int Bits>
+extern void filterAVX2(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+
+template<typename pixel_t, int Operator, int Magnitude, int Bits>
+extern void filterAVX512(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+#endif
+
+template<typename pixel_t, int Operator, int Magnitude>
+static void filterC(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept {
+    using scalar_t = std::conditional_t<std::is_integral_v<pixel_t>, int, float>;
+
+    const int width = p->width;
+    const int height = p->height;
+    const ptrdiff_t srcStride = p->srcStride / sizeof(pixel_t);
+    const ptrdiff_t dstStride = p->dstStride / sizeof(pixel_t);
+    auto srcp0 = static_cast<const pixel_t*>(p->srcp);
+    auto dstp = static_cast<pixel_t*>(p->dstp) + dstStride * top;
+    auto gyp = static_cast<pixel_t*>(Magnitude == Signed ? p->dstpGy : p->dstp) + dstStride * top;
+
+    auto reflect = [&](int y) noexcept {
+        return y < 0 ? -y : (y >= height ? (height - 1) * 2 - y : y);
+    };
+
+    // row y of the plane blurred by the binomial of radius presmooth into row, the columns first into blurred, which is padded by two pixels on
+    // either side
+    auto presmoothed = [&](int y, auto* EDGEMASKS_RESTRICT row, scalar_t* EDGEMASKS_RESTRICT blurred) noexcept {
+        auto blur = [&](auto radius) noexcept {
+            constexpr int reach = decltype(radius)::value;
+
+            auto normalize = [](scalar_t sum) noexcept -> scalar_t {
+                if constexpr (std::is_integral_v<pixel_t>)
+                    return (sum + (1 << reach * 2 >> 1)) >> (reach * 2);
+                else
+                    return sum * (1.0f / (1 << reach * 2));
+            };
+
+            const pixel_t* taps[reach * 2 + 1];
+            for (int i = -reach; i <= reach; i++)
+                taps[reach + i] = srcp0 + srcStride * reflect(reflect(y) + i);
+
+            for (int x = 0; x < width; x++)
+                blurred[x] = normalize(binomial<reach>([&](int i) noexcept { return static_cast<scalar_t>(taps[reach + i][x]); }));
+
+            for (int i = 1; i <= reach; i++) {
+                blurred[-i] = blurred[i];
+                blurred[width - 1 + i] = blurred[width - 1 - i];
+            }
+
+            for (int x = 0; x < width; x++)
+                row[x] = normalize(binomial<reach>([&](int i) noexcept { return blurred[x + i]; }));
+        };
+
+        if (p->presmooth == 1)
+            blur(std::integral_constant<int, 1>());
+        else
+            blur(std::integral_constant<int, 2>());
+    };
+
+    auto magnitude = [](scalar_t gx, scalar_t gy) noexcept {
+        if constexpr (Magnitude == Euclidean) {
+            return std::sqrt(static_cast<float>(gx) * gx + static_cast<float>(gy) * gy);
+        } else {
+            const scalar_t gxA = std::abs(gx);
+            const scalar_t gyA = std::abs(gy);
+
+            if constexpr (Magnitude == L1)
+                return gxA + gyA;
+            else if constexpr (Magnitude == Linf)
+                return std::max(gxA, gyA);
+            else if constexpr (std::is_integral_v<pixel_t>)
+                return std::max(gxA, gyA) + (std::min(gxA, gyA) >> 2) + (std::min(gxA, gyA) >> 3);
+            else
+                return std::max(gxA, gyA) + std::min(gxA, gyA) * 0.375f;
+        }
+    };
+
+    auto scaled = [&](auto g) noexcept {
+        if constexpr (std::is_integral_v<pixel_t> && std::is_integral_v<decltype(g)>) {
+            if (p->scaleMul == 1 && p->scaleShift == 0)
+                return std::min(g, p->peak);
+            else if (p->scaleMul)
+                return std::min((g * p->scaleMul + (1 << p->scaleShift >> 1)) >> p->scaleShift, p->peak);
+        }
+
+        const float gF = g * p->scale;
+
+        if constexpr (std::is_integral_v<pixel_t>)
+            return std::min(static_cast<int>(gF + 0.5f), p->peak);
+        else
+            return gF;
+    };
+
+    const scalar_t thrLo = static_cast<scalar_t>(p->thrLo);
+    const scalar_t thrHi = static_cast<scalar_t>(p->thrHi);
+    const scalar_t thrTop = std::is_integral_v<pixel_t> ? p->peak : 1;
+
+    auto thresholded = [&](scalar_t v) noexcept {
+        if (!p->threshold)
+            return v;
+
+        return v < thrLo ? 0 : (v >= thrHi ? thrTop : v);
+    };
+
+    auto finalize = [&](auto g) noexcept {
+        return thresholded(scaled(g));
+    };
+
+    auto direction = [&](scalar_t gx, scalar_t gy) noexcept -> scalar_t {
+        const float angle = gradientAngle(gx, gy);
+
+        if (std::is_integral_v<pixel_t> || p->bins)
+            return angleBin(angle, p->bins);
+        else
+            return angle;
+    };
+
+    // gx or gy for Signed: integers are rounded after adding half the range, which keeps negative values rounding like positive ones
+    auto offset = [&](scalar_t g) noexcept -> scalar_t {
+        if constexpr (std::is_integral_v<pixel_t>) {
+            const int half = (p->peak + 1) >> 1;
+
+            if (p->scaleMul == 1 && p->scaleShift == 0)
+                return std::clamp(g + half, 0, p->peak);
+            else
+                return std::clamp(static_cast<int>(g * p->scale + (half + 0.5f)), 0, p->peak);
+        } else {
+            return g * p->scale;
+        }
+    };
+
+    // the output of an operator with gx and gy, unscaled for Direction and a pair for Signed
+    auto gradient = [&](scalar_t gx, scalar_t gy) noexcept {
+        if constexpr (Magnitude == Direction)
+            return thresholded(direction(gx, gy));
+        else if constexpr (Magnitude == Signed)
+            return std::pair(offset(gx), offset(gy));
+        else
+            return finalize(magnitude(gx, gy));
+    };
+
+    auto put = [&](int x, const auto& g) noexcept {
+        if constexpr (Magnitude == Signed) {
+            dstp[x] = g.first;
+            gyp[x] = g.second;
+        } else {
+            dstp[x] = g;
+        }
+    };
+
+    if constexpr (isSeparable(Operator)) {
+        constexpr int radius = (Operator == ExPrewitt || Operator == ExSobel || Operator == FDoG) ? 2 : 1;
+        const ptrdiff_t bufferStride = width + radius * 2;
+
+        scalar_t* rows[radius * 2 + 1];
+        for (int i = 0; i < radius * 2 + 1; i++)
+            rows[i] = reinterpret_cast<scalar_t*>(buffer) + bufferStride * i + radius;
+
+        auto smoothed = reinterpret_cast<scalar_t*>(buffer) + bufferStride * (radius * 2 + 1) + radius;
+        auto derived = smoothed + bufferStride;
+        auto blurred = reinterpret_cast<scalar_t*>(buffer) + bufferStride * (radius * 2 + 3) + 2;
+
+        auto convert = [&](int y, scalar_t* EDGEMASKS_RESTRICT row) noexcept {
+            if (p->presmooth) {
+                presmoothed(y, row, blurred);
+                return;
+            }
+
+            auto srcp = srcp0 + srcStride * reflect(y);
+
+            for (int x = 0; x < width; x++)
+                row[x] = srcp[x];
+        };
+
+        auto mirror = [&](scalar_t* EDGEMASKS_RESTRICT row) noexcept {
+            for (int i = 1; i <= radius; i++) {
+                row[-i] = row[i];
+                row[width - 1 + i] = row[width - 1 - i];
+            }
+        };
+
+        for (int i = 0; i < radius * 2 + 1; i++)
+            convert(top + i - radius, rows[i]);
+
+        for (int y = top; y < bottom; y++) {
+            for (int x = 0; x < width; x++) {
+                smoothed[x] = smooth<Operator>([&](int i) noexcept { return rows[radius + i][x]; });
+                derived[x] = derive<Operator>([&](int i) noexcept { return rows[radius + i][x]; });
+            }
+
+            mirror(smoothed);
+            mirror(derived);
+
+            for (int x = 0; x < width; x++) {
+                const scalar_t gx = derive<Operator>([&](int i) noexcept { return smoothed[x + i]; });
+                const scalar_t gy = smooth<Operator>([&](int i) noexcept { return derived[x + i]; });
+                put(x, gradient(gx, gy));
+            }
+
+            if (y < bottom - 1) {
+                std::rotate(rows, rows + 1, rows + radius * 2 + 1);
+                convert(y + radius + 1, rows[radius * 2]);
+            }
+
+            dstp += dstStride;
+            gyp += dstStride;
+        }
+    } else {
+        pixel_t a00, a01, a02, a03, a04;
+        pixel_t a10, a11, a12, a13, a14;
+        pixel_t a20, a21, a22, a23, a24;
+        pixel_t a30, a31, a32, a33, a34;
+        pixel_t a40, a41, a42, a43, a44;
+
+        // rows y - radius to y + radius, mirrored at the plane's edges. with presmoothing they are blurred into a ring that advances with y
+        constexpr int radius = Operator == ExKirsch ? 2 : 1;
+        auto blurred = reinterpret_cast<scalar_t*>(buffer) + 2;
+
+        pixel_t* ring[radius * 2 + 1];
+        for (int i = 0; i < radius * 2 + 1; i++)
+            ring[i] = reinterpret_cast<pixel_t*>(blurred + width + 2) + static_cast<ptrdiff_t>(width) * i;
+
+        if (p->presmooth) {
+            for (int i = 0; i < radius * 2 + 1; i++)
+                presmoothed(top + i - radius, ring[i], blurred);
+        }
+
+        auto detect = [&]() noexcept {
+            scalar_t gx, gy, g;
+
+            if constexpr (Operator == Tritical) {
+                gx = a10 - a12;
+                gy = a01 - a21;
+            } else if constexpr (Operator == Cross) {
+                gx = a00 - a22;
+                gy = a02 - a20;
+            } else if constexpr (Operator == Robinson3) {
+                const scalar_t e0 = a02 - a20;
+                const scalar_t e1 = a01 - a21;
+                const scalar_t e2 = a00 - a22;
+                const scalar_t e3 = a10 - a12;
+                const scalar_t g1 = e0 + e1 + e2;
+                const scalar_t g2 = g1 + e3 - e0;
+                const scalar_t g3 = g2 - e0 - e1;
+                const scalar_t g4 = g3 - e1 - e2;
+                g = std::max({ std::abs(g1), std::abs(g2), std::abs(g3), std::abs(g4) });
+            } else if constexpr (Operator == Robinson5) {
+                const scalar_t e0 = a02 - a20;
+                const scalar_t e1 = a01 - a21;
+                const scalar_t e2 = a00 - a22;
+                const scalar_t e3 = a10 - a12;
+                const scalar_t s0 = e0 + e1;
+                const scalar_t s1 = e1 + e2;
+                const scalar_t s2 = e2 + e3;
+                const scalar_t s3 = e3 - e0;
+                const scalar_t g1 = s0 + s1;
+                const scalar_t g2 = s1 + s2;
+                const scalar_t g3 = s2 + s3;
+                const scalar_t g4 = s3 - s0;
+                g = std::max({ std::abs(g1), std::abs(g2), std::abs(g3), std::abs(g4) });
+            } else if constexpr (Operator == Kirsch) {
+                // walk the rim clockwise: each direction differs from the previous one by the pixel entering and the pixel leaving the positive arc
+                const scalar_t rim = a02 + a01 + a00 + a10 + a20 + a21 + a22 + a12;
+                const scalar_t g1 = 8 * (a02 + a01 + a00) - 3 * rim;
+                const scalar_t g2 = g1 + 8 * (a10 - a02);
+                const scalar_t g3 = g2 + 8 * (a20 - a01);
+                const scalar_t g4 = g3 + 8 * (a21 - a00);
+                const scalar_t g5 = g4 + 8 * (a22 - a10);
+                const scalar_t g6 = g5 + 8 * (a12 - a20);
+                const scalar_t g7 = g6 + 8 * (a02 - a21);
+                const scalar_t g8 = g7 + 8 * (a01 - a22);
+                g = std::max({ std::abs(g1), std::abs(g2), std::abs(g3), std::abs(g4), std::abs(g5), std::abs(g6), std::abs(g7), std::abs(g8) });
+            } else if constexpr (Operator == ExKirsch) {
+                // same walk on both rings: the positive arc advances by two outer and one inner pixel per direction
+                const scalar_t outer = a14 + a04 + a03 + a02 + a01 + a00 + a10 + a20 + a30 + a40 + a41 + a42 + a43 + a44 + a34 + a24;
+                const scalar_t inner = a13 + a12 + a11 + a21 + a31 + a32 + a33 + a23;
+                const scalar_t g1 = 16 * (a14 + a04 + a03 + a02 + a01 + a00 + a10) - 7 * outer + 8 * (a13 + a12 + a11) - 3 * inner;
+                const scalar_t g2 = g1 + 8 * (2 * (a20 + a30 - a14 - a04) + a21 - a13);
+                const scalar_t g3 = g2 + 8 * (2 * (a40 + a41 - a03 - a02) + a31 - a12);
+                const scalar_t g4 = g3 + 8 * (2 * (a42 + a43 - a01 - a00) + a32 - a11);
+                const scalar_t g5 = g4 + 8 * (2 * (a44 + a34 - a10 - a20) + a33 - a21);
+                const scalar_t g6 = g5 + 8 * (2 * (a24 + a14 - a30 - a40) + a23 - a31);
+                const scalar_t g7 = g6 + 8 * (2 * (a04 + a03 - a41 - a42) + a13 - a32);
+                const scalar_t g8 = g7 + 8 * (2 * (a02 + a01 - a43 - a44) + a12 - a33);
+                g = std::max({ std::abs(g1), std::abs(g2), std::abs(g3), std::abs(g4), std::abs(g5), std::abs(g6), std::abs(g7), std::abs(g8) });
+            }
+
+            if constexpr (isCompass(Operator))
+                return finalize(g);
+            else
+                return gradient(gx, gy);
+        };
+
+        for (int y = top; y < bottom; y++) {
+            auto line = [&](int i) noexcept -> const pixel_t* {
+                return p->presmooth ? ring[radius + i] : srcp0 + srcStride * reflect(y + i);
+            };
+
+            auto prev1 = line(-1);
+            auto srcp = line(0);
+            auto next1 = line(1);
+
+            if constexpr (Operator != ExKirsch) {
+                int x = 0;
+                a00 = prev1[x + 1]; a01 = prev1[x]; a02 = prev1[x + 1];
+                a10 = srcp[x + 1]; a11 = srcp[x]; a12 = srcp[x + 1];
+                a20 = next1[x + 1]; a21 = next1[x]; a22 = next1[x + 1];
+                put(x, detect());
+
+                for (x = 1; x < width - 1; x++) {
+                    a00 = prev1[x - 1]; a01 = prev1[x]; a02 = prev1[x + 1];
+                    a10 = srcp[x - 1]; a11 = srcp[x]; a12 = srcp[x + 1];
+                    a20 = next1[x - 1]; a21 = next1[x]; a22 = next1[x + 1];
+                    put(x, detect());
+                }
+
+                x = width - 1;
+                a00 = prev1[x - 1]; a01 = prev1[x]; a02 = prev1[x - 1];
+                a10 = srcp[x - 1]; a11 = srcp[x]; a12 = srcp[x - 1];
+                a20 = next1[x - 1]; a21 = next1[x]; a22 = next1[x - 1];
+                put(x, detect());
+            } else {
+                auto prev2 = line(-2);
+                auto next2 = line(2);
+
+                int x = 0;
+                a00 = prev2[x + 2]; a01 = prev2[x + 1]; a02 = prev2[x]; a03 = prev2[x + 1]; a04 = prev2[x + 2];
+                a10 = prev1[x + 2]; a11 = prev1[x + 1]; a12 = prev1[x]; a13 = prev1[x + 1]; a14 = prev1[x + 2];
+                a20 = srcp[x + 2]; a21 = srcp[x + 1]; a22 = srcp[x]; a23 = srcp[x + 1]; a24 = srcp[x + 2];
+                a30 = next1[x + 2]; a31 = next1[x + 1]; a32 = next1[x]; a33 = next1[x + 1]; a34 = next1[x + 2];
+                a40 = next2[x + 2]; a41 = next2[x + 1]; a42 = next2[x]; a43 = next2[x + 1]; a44 = next2[x + 2];
+                put(x, detect());
+
+                x = 1;
+                a00 = prev2[x]; a01 = prev2[x - 1]; a02 = prev2[x]; a03 = prev2[x + 1]; a04 = prev2[x + 2];
+                a10 = prev1[x]; a11 = prev1[x - 1]; a12 = prev1[x]; a13 = prev1[x + 1]; a14 = prev1[x + 2];
+                a20 = srcp[x]; a21 = srcp[x - 1]; a22 = srcp[x]; a23 = srcp[x + 1]; a24 = srcp[x + 2];
+                a30 = next1[x]; a31 = next1[x - 1]; a32 = next1[x]; a33 = next1[x + 1]; a34 = next1[x + 2];
+                a40 = next2[x]; a41 = next2[x - 1]; a42 = next2[x]; a43 = next2[x + 1]; a44 = next2[x + 2];
+                put(x, detect());
+
+                for (x = 2; x < width - 2; x++) {
+                    a00 = prev2[x - 2]; a01 = prev2[x - 1]; a02 = prev2[x]; a03 = prev2[x + 1]; a04 = prev2[x + 2];
+                    a10 = prev1[x - 2]; a11 = prev1[x - 1]; a12 = prev1[x]; a13 = prev1[x + 1]; a14 = prev1[x + 2];
+                    a20 = srcp[x - 2]; a21 = srcp[x - 1]; a22 = srcp[x]; a23 = srcp[x + 1]; a24 = srcp[x + 2];
+                    a30 = next1[x - 2]; a31 = next1[x - 1]; a32 = next1[x]; a33 = next1[x + 1]; a34 = next1[x + 2];
+                    a40 = next2[x - 2]; a41 = next2[x - 1]; a42 = next2[x]; a43 = next2[x + 1]; a44 = next2[x + 2];
+                    put(x, detect());
+                }
+
+                x = width - 2;
+                a00 = prev2[x - 2]; a01 = prev2[x - 1]; a02 = prev2[x]; a03 = prev2[x + 1]; a04 = prev2[x];
+                a10 = prev1[x - 2]; a11 = prev1[x - 1]; a12 = prev1[x]; a13 = prev1[x + 1]; a14 = prev1[x];
+                a20 = srcp[x - 2]; a21 = srcp[x - 1]; a22 = srcp[x]; a23 = srcp[x + 1]; a24 = srcp[x];
+                a30 = next1[x - 2]; a31 = next1[x - 1]; a32 = next1[x]; a33 = next1[x + 1]; a34 = next1[x];
+                a40 = next2[x - 2]; a41 = next2[x - 1]; a42 = next2[x]; a43 = next2[x + 1]; a44 = next2[x];
+                put(x, detect());
+
+                x = width - 1;
+                a00 = prev2[x - 2]; a01 = prev2[x - 1]; a02 = prev2[x]; a03 = prev2[x - 1]; a04 = prev2[x - 2];
+                a10 = prev1[x - 2]; a11 = prev1[x - 1]; a12 = prev1[x]; a13 = prev1[x - 1]; a14 = prev1[x - 2];
+                a20 = srcp[x - 2]; a21 = srcp[x - 1]; a22 = srcp[x]; a23 = srcp[x - 1]; a24 = srcp[x - 2];
+                a30 = next1[x - 2]; a31 = next1[x - 1]; a32 = next1[x]; a33 = next1[x - 1]; a34 = next1[x - 2];
+                a40 = next2[x - 2]; a41 = next2[x - 1]; a42 = next2[x]; a43 = next2[x - 1]; a44 = next2[x - 2];
+                put(x, detect());
+            }
+
+            if (p->presmooth && y < bottom - 1) {
+                std::rotate(ring, ring + 1, ring + radius * 2 + 1);
+                presmoothed(y + radius + 1, ring[radius * 2], blurred);
+            }
+
+            dstp += dstStride;
+            gyp += dstStride;
+        }
+    }
+}
+
+template<typename pixel_t, int Operator>
+static auto selectC(int magnitude) noexcept {
+    if constexpr (isCompass(Operator))
+        return filterC<pixel_t, Operator, Linf>;
+    else if (magnitude == L1)
+        return filterC<pixel_t, Operator, L1>;
+    else if (magnitude == Linf)
+        return filterC<pixel_t, Operator, Linf>;
+    else if (magnitude == Approx)
+        return filterC<pixel_t, Operator, Approx>;
+    else if (magnitude == Direction)
+        return filterC<pixel_t, Operator, Direction>;
+    else if (magnitude == Signed)
+        return filterC<pixel_t, Operator, Signed>;
+    else
+        return filterC<pixel_t, Operator, Euclidean>;
+}
+
+template<typename pixel_t>
+static auto selectC(int op, int magnitude) noexcept {
+    if (op == Tritical)
+        return selectC<pixel_t, Tritical>(magnitude);
+    else if (op == Cross)
+        return selectC<pixel_t, Cross>(magnitude);
+    else if (op == Prewitt)
+        return selectC<pixel_t, Prewitt>(magnitude);
+    else if (op == Sobel)
+        return selectC<pixel_t, Sobel>(magnitude);
+    else if (op == Scharr)
+        return selectC<pixel_t, Scharr>(magnitude);
+    else if (op == RScharr)
+        return selectC<pixel_t, RScharr>(magnitude);
+    else if (op == Kroon)
+        return selectC<pixel_t, Kroon>(magnitude);
+    else if (op == Robinson3)
+        return selectC<pixel_t, Robinson3>(magnitude);
+    else if (op == Robinson5)
+        return selectC<pixel_t, Robinson5>(magnitude);
+    else if (op == Kirsch)
+        return selectC<pixel_t, Kirsch>(magnitude);
+    else if (op == ExPrewitt)
+        return selectC<pixel_t, ExPrewitt>(magnitude);
+    else if (op == ExSobel)
+        return selectC<pixel_t, ExSobel>(magnitude);
+    else if (op == FDoG)
+        return selectC<pixel_t, FDoG>(magnitude);
+    else
+        return selectC<pixel_t, ExKirsch>(magnitude);
+}
+
+template<typename pixel_t, int Operator, int Magnitude>
+static auto selectPortable(int bits) noexcept {
+    if constexpr (std::is_same_v<pixel_t, uint16_t>) {
+        if constexpr (magnitudeBound(Operator, Magnitude, 1023) <= INT16_MAX) {
+            if (bits <= 10)
+                return filterPortable<pixel_t, Operator, Magnitude, 10>;
+        }
+
+        if constexpr (magnitudeBound(Operator, Magnitude, 4095) <= INT16_MAX) {
+            if (bits <= 12)
+                return filterPortable<pixel_t, Operator, Magnitude, 12>;
+        }
+
+        return filterPortable<pixel_t, Operator, Magnitude, 16>;
+    } else {
+        return filterPortable<pixel_t, Operator, Magnitude, std::is_same_v<pixel_t, uint8_t> ? 8 : 0>;
+    }
+}
+
+template<typename pixel_t, int Operator>
+static auto selectPortable(int magnitude, int bits) noexcept {
+    if constexpr (isCompass(Operator))
+        return selectPortable<pixel_t, Operator, Linf>(bits);
+    else if (magnitude == L1)
+        return selectPortable<pixel_t, Operator, L1>(bits);
+    else if (magnitude == Linf)
+        return selectPortable<pixel_t, Operator, Linf>(bits);
+    else if (magnitude == Approx)
+        return selectPortable<pixel_t, Operator, Approx>(bits);
+    else if (magnitude == Direction)
+        return selectPortable<pixel_t, Operator, Direction>(bits);
+    else if (magnitude == Signed)
+        return selectPortable<pixel_t, Operator, Signed>(bits);
+    else
+        return selectPortable<pixel_t, Operator, Euclidean>(bits);
+}
+
+template<typename pixel_t>
+static auto selectPortable(int op, int magnitude, int bits) noexcept {
+    if (op == Tritical)
+        return selectPortable<pixel_t, Tritical>(magnitude, bits);
+    else if (op == Cross)
+        return selectPortable<pixel_t, Cross>(magnitude, bits);
+    else if (op == Prewitt)
+        return selectPortable<pixel_t, Prewitt>(magnitude, bits);
+    else if (op == Sobel)
+        return selectPortable<pixel_t, Sobel>(magnitude, bits);
+    else if (op == Scharr)
+        return selectPortable<pixel_t, Scharr>(magnitude, bits);
+    else if (op == RScharr)
+        return selectPortable<pixel_t, RScharr>(magnitude, bits);
+    else if (op == Kroon)
+        return selectPortable<pixel_t, Kroon>(magnitude, bits);
+    else if (op == Robinson3)
+        return selectPortable<pixel_t, Robinson3>(magnitude, bits);
+    else if (op == Robinson5)
+        return selectPortable<pixel_t, Robinson5>(magnitude, bits);
+    else if (op == Kirsch)
+        return selectPortable<pixel_t, Kirsch>(magnitude, bits);
+    else if (op == ExPrewitt)
+        return selectPortable<pixel_t, ExPrewitt>(magnitude, bits);
+    else if (op == ExSobel)
+        return selectPortable<pixel_t, ExSobel>(magnitude, bits);
+    else if (op == FDoG)
+        return selectPortable<pixel_t, FDoG>(magnitude, bits);
+    else
+        return selectPortable<pixel_t, ExKirsch>(magnitude, bits);
+}
+
+#ifdef EDGEMASKS_X86
+template<typename pixel_t, int Operator, int Magnitude>
+static auto selectSSE4(int bits) noexcept {
+    if constexpr (std::is_same_v<pixel_t, uint16_t>) {
+        if constexpr (magnitudeBound(Operator, Magnitude, 1023) <= INT16_MAX) {
+            if (bits <= 10)
+                return filterSSE4<pixel_t, Operator, Magnitude, 10>;
+        }
+
+        if constexpr (magnitudeBound(Operator, Magnitude, 4095) <= INT16_MAX) {
+            if (bits <= 12)
+                return filterSSE4<pixel_t, Operator, Magnitude, 12>;
+        }
+
+        return filterSSE4<pixel_t, Operator, Magnitude, 16>;
+    } else {
+        return filterSSE4<pixel_t, Operator, Magnitude, std::is_same_v<pixel_t, uint8_t> ? 8 : 0>;
+    }
+}
+
+template<typename pixel_t, int Operator>
+static auto selectSSE4(int magnitude, int bits) noexcept {
+    if constexpr (isCompass(Operator))
+        return selectSSE4<pixel_t, Operator, Linf>(bits);
+    else if (magnitude == L1)
+        return selectSSE4<pixel_t, Operator, L1>(bits);
+    else if (magnitude == Linf)
+        return selectSSE4<pixel_t, Operator, Linf>(bits);
+    else if (magnitude == Approx)
+        return selectSSE4<pixel_t, Operator, Approx>(bits);
+    else if (magnitude == Direction)
+        return selectSSE4<pixel_t, Operator, Direction>(bits);
+    else if (magnitude == Signed)
+        return selectSSE4<pixel_t, Operator, Signed>(bits);
+    else
+        return selectSSE4<pixel_t, Operator, Euclidean>(bits);
+}
+
+template<typename pixel_t>
+static auto selectSSE4(int op, int magnitude, int bits) noexcept {
+    if (op == Tritical)
+        return selectSSE4<pixel_t, Tritical>(magnitude, bits);
+    else if (op == Cross)
+        return selectSSE4<pixel_t, Cross>(magnitude, bits);
+    else if (op == Prewitt)
+        return selectSSE4<pixel_t, Prewitt>(magnitude, bits);
+    else if (op == Sobel)
+        return selectSSE4<pixel_t, Sobel>(magnitude, bits);
+    else if (op == Scharr)
+        return selectSSE4<pixel_t, Scharr>(magnitude, bits);
+    else if (op == RScharr)
+        return selectSSE4<pixel_t, RScharr>(magnitude, bits);
+    else if (op == Kroon)
+        return selectSSE4<pixel_t, Kroon>(magnitude, bits);
+    else if (op == Robinson3)
+        return selectSSE4<pixel_t, Robinson3>(magnitude, bits);
+    else if (op == Robinson5)
+        return selectSSE4<pixel_t, Robinson5>(magnitude, bits);
+    else if (op == Kirsch)
+        return selectSSE4<pixel_t, Kirsch>(magnitude, bits);
+    else if (op == ExPrewitt)
+        return selectSSE4<pixel_t, ExPrewitt>(magnitude, bits);
+    else if (op == ExSobel)
+        return selectSSE4<pixel_t, ExSobel>(magnitude, bits);
+    else if (op == FDoG)
+        return selectSSE4<pixel_t, FDoG>(magnitude, bits);
+    else
+        return selectSSE4<pixel_t, ExKirsch>(magnitude, bits);
+}
+
+template<typename pixel_t, int Operator, int Magnitude>
+static auto selectAVX2(int bits) noexcept {
+    if constexpr (std::is_same_v<pixel_t, uint16_t>) {
+        if constexpr (magnitudeBound(Operator, Magnitude, 1023) <= INT16_MAX) {
+            if (bits <= 10)
+                return filterAVX2<pixel_t, Operator, Magnitude, 10>;
+        }
+
+        if constexpr (magnitudeBound(Operator, Magnitude, 4095) <= INT16_MAX) {
+            if (bits <= 12)
+                return filterAVX2<pixel_t, Operator, Magnitude, 12>;
+        }
+
+        return filterAVX2<pixel_t, Operator, Magnitude, 16>;
+    } else {
+        return filterAVX2<pixel_t, Operator, Magnitude, std::is_same_v<pixel_t, uint8_t> ? 8 : 0>;
+    }
+}
+
+template<typename pixel_t, int Operator>
+static auto selectAVX2(int magnitude, int bits) noexcept {
+    if constexpr (isCompass(Operator))
+        return selectAVX2<pixel_t, Operator, Linf>(bits);
+    else if (magnitude == L1)
+        return selectAVX2<pixel_t, Operator, L1>(bits);
+    else if (magnitude == Linf)
+        return selectAVX2<pixel_t, Operator, Linf>(bits);
+    else if (magnitude == Approx)
+        return selectAVX2<pixel_t, Operator, Approx>(bits);
+    else if (magnitude == Direction)
+        return selectAVX2<pixel_t, Operator, Direction>(bits);
+    else if (magnitude == Signed)
+        return selectAVX2<pixel_t, Operator, Signed>(bits);
+    else
+        return selectAVX2<pixel_t, Operator, Euclidean>(bits);
+}
+
+template<typename pixel_t>
+static auto selectAVX2(int op, int magnitude, int bits) noexcept {
+    if (op == Tritical)
+        return selectAVX2<pixel_t, Tritical>(magnitude, bits);
+    else if (op == Cross)
+        return selectAVX2<pixel_t, Cross>(magnitude, bits);
+    else if (op == Prewitt)
+        return selectAVX2<pixel_t, Prewitt>(magnitude, bits);
+    else if (op == Sobel)
+        return selectAVX2<pixel_t, Sobel>(magnitude, bits);
+    else if (op == Scharr)
+        return selectAVX2<pixel_t, Scharr>(magnitude, bits);
+    else if (op == RScharr)
+        return selectAVX2<pixel_t, RScharr>(magnitude, bits);
+    else if (op == Kroon)
+        return selectAVX2<pixel_t, Kroon>(magnitude, bits);
+    else if (op == Robinson3)
+        return selectAVX2<pixel_t, Robinson3>(magnitude, bits);
+    else if (op == Robinson5)
+        return selectAVX2<pixel_t, Robinson5>(magnitude, bits);
+    else if (op == Kirsch)
+        return selectAVX2<pixel_t, Kirsch>(magnitude, bits);
+    else if (op == ExPrewitt)
+        return selectAVX2<pixel_t, ExPrewitt>(magnitude, bits);
+    else if (op == ExSobel)
+        return selectAVX2<pixel_t, ExSobel>(magnitude, bits);
+    else if (op == FDoG)
+        return selectAVX2<pixel_t, FDoG>(magnitude, bits);
+    else
+        return selectAVX2<pixel_t, ExKirsch>(magnitude, bits);
+}
+
+template<typename pixel_t, int Operator, int Magnitude>
+static auto selectAVX512(int bits) noexcept {
+    if constexpr (std::is_same_v<pixel_t, uint16_t>) {
+        if constexpr (magnitudeBound(Operator, Magnitude, 1023) <= INT16_MAX) {
+            if (bits <= 10)
+                return filterAVX512<pixel_t, Operator, Magnitude, 10>;
+        }
+
+        if constexpr (magnitudeBound(Operator, Magnitude, 4095) <= INT16_MAX) {
+            if (bits <= 12)
+                return filterAVX512<pixel_t, Operator, Magnitude, 12>;
+        }
+
+        return filterAVX512<pixel_t, Operator, Magnitude, 16>;
+    } else {
+        return filterAVX512<pixel_t, Operator, Magnitude, std::is_same_v<pixel_t, uint8_t> ? 8 : 0>;
+    }
+}
+
+template<typename pixel_t, int Operator>
+static auto selectAVX512(int magnitude, int bits) noexcept {
+    if constexpr (isCompass(Operator))
+        return selectAVX512<pixel_t, Operator, Linf>(bits);
+    else if (magnitude == L1)
+        return selectAVX512<pixel_t, Operator, L1>(bits);
+    else if (magnitude == Linf)
+        return selectAVX512<pixel_t, Operator, Linf>(bits);
+    else if (magnitude == Approx)
+        return selectAVX512<pixel_t, Operator, Approx>(bits);
+    else if (magnitude == Direction)
+        return selectAVX512<pixel_t, Operator, Direction>(bits);
+    else if (magnitude == Signed)
+        return selectAVX512<pixel_t, Operator, Signed>(bits);
+    else
+        return selectAVX512<pixel_t, Operator, Euclidean>(bits);
+}
+
+template<typename pixel_t>
+static auto selectAVX512(int op, int magnitude, int bits) noexcept {
+    if (op == Tritical)
+        return selectAVX512<pixel_t, Tritical>(magnitude, bits);
+    else if (op == Cross)
+        return selectAVX512<pixel_t, Cross>(magnitude, bits);
+    else if (op == Prewitt)
+        return selectAVX512<pixel_t, Prewitt>(magnitude, bits);
+    else if (op == Sobel)
+        return selectAVX512<pixel_t, Sobel>(magnitude, bits);
+    else if (op == Scharr)
+        return selectAVX512<pixel_t, Scharr>(magnitude, bits);
+    else if (op == RScharr)
+        return selectAVX512<pixel_t, RScharr>(magnitude, bits);
+    else if (op == Kroon)
+        return selectAVX512<pixel_t, Kroon>(magnitude, bits);
+    else if (op == Robinson3)
+        return selectAVX512<pixel_t, Robinson3>(magnitude, bits);
+    else if (op == Robinson5)
+        return selectAVX512<pixel_t, Robinson5>(magnitude, bits);
+    else if (op == Kirsch)
+        return selectAVX512<pixel_t, Kirsch>(magnitude, bits);
+    else if (op == ExPrewitt)
+        return selectAVX512<pixel_t, ExPrewitt>(magnitude, bits);
+    else if (op == ExSobel)
+        return selectAVX512<pixel_t, ExSobel>(magnitude, bits);
+    else if (op == FDoG)
+        return selectAVX512<pixel_t, FDoG>(magnitude, bits);
+    else
+        return selectAVX512<pixel_t, ExKirsch>(magnitude, bits);
+}
+#endif
+
+template<typename pixel_t>
+static kernel_t selectKernel(int op, int magnitude, int bits, int opt) noexcept {
+#ifdef EDGEMASKS_X86
+    const int iset = instrset_detect();
+
+    if ((opt == 0 && iset >= 10) || opt == 4)
+        return selectAVX512<pixel_t>(op, magnitude, bits);
+    else if ((opt == 0 && iset >= 8) || opt == 3)
+        return selectAVX2<pixel_t>(op, magnitude, bits);
+    else if ((opt == 0 && iset >= 5) || opt == 2)
+        return selectSSE4<pixel_t>(op, magnitude, bits);
+#endif
+
+    if (opt == 0 || opt == 5)
+        return selectPortable<pixel_t>(op, magnitude, bits);
+    else
+        return selectC<pixel_t>(op, magnitude);
+}
+
+kernel_t selectKernel(int op, int magnitude, int bytesPerSample, int bits, int opt) noexcept {
+    if (bytesPerSample == 1)
+        return selectKernel<uint8_t>(op, magnitude, bits, opt);
+    else if (bytesPerSample == 2)
+        return selectKernel<uint16_t>(op, magnitude, bits, opt);
+    else
+        return selectKernel<float>(op, magnitude, bits, opt);
+}
+
+const char* isaName(int opt) noexcept {
+#ifdef EDGEMASKS_X86
+    const int iset = instrset_detect();
+
+    if ((opt == 0 && iset >= 10) || opt == 4)
+        return "avx512";
+    else if ((opt == 0 && iset >= 8) || opt == 3)
+        return "avx2";
+    else if ((opt == 0 && iset >= 5) || opt == 2)
+        return "sse4.1";
+#endif
+
+    if (opt == 0 || opt == 5)
+        return "portable";
+    else
+        return "c";
+}
+
+// values of the weak edges Canny leaves for hysteresis, and of the strong edges hysteresis has followed, between 0 and the strong edges at
+// the peak
+template<typename pixel_t>
+static constexpr pixel_t cannyWeak = std::is_integral_v<pixel_t> ? 1 : 0.25f;
+
+template<typename pixel_t>
+static constexpr pixel_t cannyLinked = std::is_integral_v<pixel_t> ? 2 : 0.5f;
+
+template<typename pixel_t, int Operator, int Magnitude>
+static void filterCanny(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept {
+    using scalar_t = std::conditional_t<std::is_integral_v<pixel_t>, int, float>;
+    constexpr int radius = (Operator == ExPrewitt || Operator == ExSobel || Operator == FDoG) ? 2 : 1;
+
+    const int width = p->width;
+    const int height = p->height;
+    const ptrdiff_t srcStride = p->srcStride / sizeof(pixel_t);
+    const ptrdiff_t dstStride = p->dstStride / sizeof(pixel_t);
+    auto srcp0 = static_cast<const pixel_t*>(p->srcp);
+    auto dstp = static_cast<pixel_t*>(p->dstp) + dstStride * top;
+    const pixel_t strong = std::is_integral_v<pixel_t> ? p->peak : 1;
+    const float scale = p->scale;
+    const float thrLo = p->thrLo;
+    const float thrHi = p->thrHi;
+
+    // the smoothed and differentiated rows of the gradient being computed, the magnitudes of the three rows around the one being suppressed,
+    // padded by one pixel on either side, and the directions of that row and the next, all as wide as a row of the smoothed values
+    const ptrdiff_t bufferStride = width + radius * 2;
+    auto smoothed = reinterpret_cast<scalar_t*>(buffer) + radius;
+    auto derived = smoothed + bufferStride;
+
+    float* magnitudes[3];
+    for (int i = 0; i < 3; i++)
+        magnitudes[i] = reinterpret_cast<float*>(buffer) + bufferStride * (i + 2) + 1;
+
+    int32_t* directions[2];
+    for (int i = 0; i < 2; i++)
+        directions[i] = reinterpret_cast<int32_t*>(buffer) + bufferStride * (i + 5);
+
+    auto mirror = [&](auto* EDGEMASKS_RESTRICT row, int n) noexcept {
+        for (int i = 1; i <= n; i++) {
+            row[-i] = row[i];
+            row[width - 1 + i] = row[width - 1 - i];
+        }
+    };
+
+    // magnitude and quantized direction of the gradient of row y, mirrored at the plane's edges like the source.
+    // 0 is horizontal, 1 the diagonal from the top left, 2 vertical and 3 the diagonal from the top right
+    auto gradient = [&](int y, float* EDGEMASKS_RESTRICT magnitude, int32_t* EDGEMASKS_RESTRICT direction) noexcept {
+        const pixel_t* rows[radius * 2 + 1];
+        for (int i = -radius; i <= radius; i++) {
+            const int row = std::abs(y + i) > height - 1 ? (height - 1) * 2 - std::abs(y + i) : std::abs(y + i);
+            rows[radius + i] = srcp0 + srcStride * row;
+        }
+
+        for (int x = 0; x < width; x++) {
+            smoothed[x] = smooth<Operator>([&](int i) noexcept { return static_cast<scalar_t>(rows[radius + i][x]); });
+            derived[x] = derive<Operator>([&](int i) noexcept { return static_cast<scalar_t>(rows[radius + i][x]); });
+        }
+
+        mirror(smoothed, radius);
+        mirror(derived, radius);
+
+        for (int x = 0; x < width; x++) {
+            const float gx = derive<Operator>([&](int i) noexcept { return smoothed[x + i]; });
+            const float gy = smooth<Operator>([&](int i) noexcept { return derived[x + i]; });
+            const float gxA = std::abs(gx);
+            const float gyA = std::abs(gy);
+            float g;
+
+            if constexpr (Magnitude == Euclidean)
+                g = std::sqrt(gx * gx + gy * gy);
+            else if constexpr (Magnitude == L1)
+                g = gxA + gyA;
+            else if constexpr (Magnitude == Linf)
+                g = std::max(gxA, gyA);
+            else
+                g = std::max(gxA, gyA) + std::min(gxA, gyA) * 0.375f;
+
+            magnitude[x] = g * scale;
+
+            // sectors of 45 degrees around the axes and diagonals, split at tan(22.5) and tan(67.5). arithmetic rather than branches, so that
+            // the loop vectorizes
+            const int32_t horizontal = gyA <= gxA * 0.41421356f;
+            const int32_t vertical = gyA >= gxA * 2.41421356f;
+            const int32_t diagonal = 3 - 2 * ((gx > 0.0f) == (gy > 0.0f));
+            direction[x] = (1 - horizontal) * (vertical * 2 + (1 - vertical) * diagonal);
+        }
+
+        mirror(magnitude, 1);
+    };
+
+    gradient(top - 1, magnitudes[0], directions[1]);
+    gradient(top, magnitudes[1], directions[0]);
+
+    for (int y = top; y < bottom; y++) {
+        gradient(y + 1, magnitudes[2], directions[1]);
+
+        const float* EDGEMASKS_RESTRICT above = magnitudes[0];
+        const float* EDGEMASKS_RESTRICT center = magnitudes[1];
+        const float* EDGEMASKS_RESTRICT below = magnitudes[2];
+        const int32_t* EDGEMASKS_RESTRICT direction = directions[0];
+
+        // a pixel survives if it exceeds the neighbour before it across the edge and is not below the one after it, so that plateaus stay one
+        // pixel wide. all neighbours are loaded and the pair selected, and the conditions are combined without short circuits, again so that the
+        // loop vectorizes
+        for (int x = 0; x < width; x++) {
+            const float g = center[x];
+            const int32_t d = direction[x];
+            const float l = center[x - 1], r = center[x + 1];
+            const float al = above[x - 1], a = above[x], ar = above[x + 1];
+            const float bl = below[x - 1], b = below[x], br = below[x + 1];
+            const float before = d == 0 ? l : (d == 1 ? al : (d == 2 ? a : ar));
+            const float after = d == 0 ? r : (d == 1 ? br : (d == 2 ? b : bl));
+            const bool keep = (g >= thrLo) & (g > before) & (g >= after);
+            dstp[x] = keep ? (g >= thrHi ? strong : cannyWeak<pixel_t>) : 0;
+        }
+
+        std::rotate(magnitudes, magnitudes + 1, magnitudes + 3);
+        std::swap(directions[0], directions[1]);
+        dstp += dstStride;
+    }
+}
+
+template<typename pixel_t>
+static void hysteresis(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, void* EDGEMASKS_RESTRICT queue0) noexcept {
+    const int width = p->width;
+    const int height = p->height;
+    const ptrdiff_t dstStride = p->dstStride / sizeof(pixel_t);
+    auto dstp0 = static_cast<pixel_t*>(p->dstp);
+    const pixel_t strong = std::is_integral_v<pixel_t> ? p->peak : 1;
+
+    // strong pixels turn linked as they enter the queue, and so do the weak pixels reached from them, so that every pixel enters it at most once
+    // and it never holds more than the plane's pixels
+    auto queue = static_cast<uint32_t*>(queue0);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (dstp0[dstStride * y + x] != strong)
+                continue;
+
+            size_t size = 0;
+            dstp0[dstStride * y + x] = cannyLinked<pixel_t>;
+            queue[size++] = static_cast<uint32_t>(width) * y + x;
+
+            while (size) {
+                const uint32_t i = queue[--size];
+                const int cy = i / width;
+                const int cx = i % width;
+
+                for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, height - 1); ny++) {
+                    pixel_t* dstp = dstp0 + dstStride * ny;
+
+                    for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, width - 1); nx++) {
+                        if (dstp[nx] == cannyWeak<pixel_t> || dstp[nx] == strong) {
+                            dstp[nx] = cannyLinked<pixel_t>;
+                            queue[size++] = static_cast<uint32_t>(width) * ny + nx;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (int y = 0; y < height; y++) {
+        pixel_t* dstp = dstp0 + dstStride * y;
+
+        for (int x = 0; x < width; x++)
+            dstp[x] = dstp[x] == cannyLinked<pixel_t> ? strong : 0;
+    }
+}
+
+template<typename pixel_t, int Operator>
+static kernel_t selectCanny(int magnitude) noexcept {
+    if (magnitude == L1)
+        return filterCanny<pixel_t, Operator, L1>;
+    else if (magnitude == Linf)
+        return filterCanny<pixel_t, Operator, Linf>;
+    else if (magnitude == Approx)
+        return filterCanny<pixel_t, Operator, Approx>;
+    else
+        return filterCanny<pixel_t, Operator, Euclidean>;
+}
+
+template<typename pixel_t>
+static kernel_t selectCanny(int op, int magnitude) noexcept {
+    if (op == Scharr)
+        return selectCanny<pixel_t, Scharr>(magnitude);
+    else
+        return selectCanny<pixel_t, Sobel>(magnitude);
+}
+
+kernel_t selectCanny(int op, int magnitude, int bytesPerSample) noexcept {
+    if (bytesPerSample == 1)
+        return selectCanny<uint8_t>(op, magnitude);
+    else if (bytesPerSample == 2)
+        return selectCanny<uint16_t>(op, magnitude);
+    else
+        return selectCanny<float>(op, magnitude);
+}
+
+hysteresis_t selectHysteresis(int bytesPerSample) noexcept {
+    if (bytesPerSample == 1)
+        return hysteresis<uint8_t>;
+    else if (bytesPerSample == 2)
+        return hysteresis<uint16_t>;
+    else
+        return hysteresis<float>;
+}
+
+void setThresholds(EdgeMasksPlane* p, float lo, float hi) noexcept {
+    if (p->peak) {
+        lo = std::clamp(std::ceil(lo), 0.0f, static_cast<float>(p->peak));
+        hi = std::clamp(std::ceil(hi), 0.0f, static_cast<float>(p->peak) + 1.0f);
+    }
+
+    p->thrLo = lo;
+    p->thrHi = hi;
+    p->threshold = lo > 0.0f || hi <= (p->peak ? p->peak : std::numeric_limits<float>::max());
+}
+
+void foldScale(EdgeMasksPlane* p, int op, int magnitude) noexcept {
+    const int bound = magnitudeBound(op, isCompass(op) ? Linf : magnitude, p->peak);
+
+    // Fold scale into (g * scaleMul + rounding) >> scaleShift for the integer magnitudes, but only if that rounds exactly like
+    // the float path for every value up to the bound. A scale of 1.0 is the identity and skips the multiply altogether.
+    if (!p->peak)
+        return;
+
+    if (p->scale == 1.0f) {
+        p->scaleMul = 1;
+        p->scaleShift = 0;
+        return;
+    }
+
+    // Signed is rounded from the float product offset by half the range, which the fixed point cannot reproduce for negative values
+    if (magnitude == Signed) {
+        p->scaleMul = 0;
+        p->scaleShift = 0;
+        return;
+    }
+
+    int shift = 15;
+    while (shift > 0 && (std::lround(p->scale * (1 << shift)) > INT16_MAX ||
+                         std::lround(p->scale * (1 << shift)) * static_cast<int64_t>(bound) + (1 << shift >> 1) > INT32_MAX))
+        shift--;
+
+    const int mul = std::lround(p->scale * (1 << shift));
+    bool exact = shift > 0 && mul > 0;
+
+    for (int g = 0; g <= bound && exact; g++) {
+        const int reference = std::min(static_cast<int>(g * p->scale + 0.5f), p->peak);
+        exact = std::min((g * mul + (1 << shift >> 1)) >> shift, p->peak) == reference;
+
+        if (reference == p->peak)
+            break;
+    }
+
+    p->scaleMul = exact ? mul : 0;
+    p->scaleShift = exact ? shift : 0;
+}
+
+static_assert(static_cast<int>(EDGEMASKS_TRITICAL) == Tritical && static_cast<int>(EDGEMASKS_EXKIRSCH) == ExKirsch,
+              "the operators of the C API have to be numbered like Operator");
+
+int edgemasks_process_plane(EdgeMasksOperator op, EdgeMasksSampleType type, const void* src, ptrdiff_t src_stride, void* dst, ptrdiff_t dst_stride,
+                            int width, int height, const EdgeMasksParams* params, EdgeMasksIsa isa) {
+    if (op < EDGEMASKS_TRITICAL || op > EDGEMASKS_EXKIRSCH || type < EDGEMASKS_UINT8 || type > EDGEMASKS_FLOAT || isa < EDGEMASKS_ISA_AUTO ||
+        isa > EDGEMASKS_ISA_PORTABLE || !params || params->magnitude < 0 || params->magnitude > 3 || !(params->scale > 0.0f) ||
+        !(params->thr_lo >= 0.0f) || !(params->thr_hi >= params->thr_lo) || params->presmooth < 0 || params->presmooth > 2 ||
+        (type == EDGEMASKS_UINT8 && params->bits != 8) || (type == EDGEMASKS_UINT16 && (params->bits < 9 || params->bits > 16)))
+        return EDGEMASKS_ERROR_ARGUMENT;
+
+    const int bytesPerSample = type == EDGEMASKS_UINT8 ? 1 : (type == EDGEMASKS_UINT16 ? 2 : 4);
+    const int bits = type == EDGEMASKS_FLOAT ? 32 : params->bits;
+    const int matrix = (op == EDGEMASKS_EXPREWITT || op == EDGEMASKS_EXSOBEL || op == EDGEMASKS_FDOG || op == EDGEMASKS_EXKIRSCH) ? 5 : 3;
+
+    if (!src || !dst || width < matrix || height < matrix || src_stride < static_cast<ptrdiff_t>(width) * bytesPerSample ||
+        dst_stride < static_cast<ptrdiff_t>(width) * bytesPerSample ||
+        ((reinterpret_cast<uintptr_t>(src) | reinterpret_cast<uintptr_t>(dst) | static_cast<uintptr_t>(src_stride | dst_stride)) & 63))
+        return EDGEMASKS_ERROR_ARGUMENT;
+
+#ifdef EDGEMASKS_X86
+    const int iset = instrset_detect();
+
+    if ((isa == EDGEMASKS_ISA_SSE4 && iset < 5) || (isa == EDGEMASKS_ISA_AVX2 && iset < 8) || (isa == EDGEMASKS_ISA_AVX512 && iset < 10))
+        return EDGEMASKS_ERROR_UNSUPPORTED;
+#else
+    if (isa == EDGEMASKS_ISA_SSE4 || isa == EDGEMASKS_ISA_AVX2 || isa == EDGEMASKS_ISA_AVX512)
+        return EDGEMASKS_ERROR_UNSUPPORTED;
+#endif
+
+    EdgeMasksPlane p{ src, dst, src_stride, dst_stride, width, height, params->scale / operatorNorm(op), 0, 0,
+                      type == EDGEMASKS_FLOAT ? 0 : (1 << bits) - 1 };
+    p.presmooth = params->presmooth;
+    foldScale(&p, op, params->magnitude);
+    setThresholds(&p, params->thr_lo, params->thr_hi);
+
+    // scratch space of each thread, grown to the widest plane it has processed and kept for later calls
+    struct Buffer {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+
+        ~Buffer() {
+            operator delete[](data, std::align_val_t(64));
+        }
+    };
+
+    thread_local Buffer buffer;
+
+    if (buffer.size < bufferSize(width, matrix)) {
+        operator delete[](buffer.data, std::align_val_t(64));
+        buffer.data = static_cast<uint8_t*>(operator new[](bufferSize(width, matrix), std::align_val_t(64), std::nothrow));
+        buffer.size = buffer.data ? bufferSize(width, matrix) : 0;
+
+        if (!buffer.data)
+            return EDGEMASKS_ERROR_MEMORY;
+    }
+
+    selectKernel(op, params->magnitude, bytesPerSample, bits, isa)(&p, 0, height, buffer.data);
+    return EDGEMASKS_OK;
+}
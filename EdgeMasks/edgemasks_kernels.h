@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#ifdef EDGEMASKS_X86
+#include "vectorclass/vectorclass.h"
+#endif
+
+#ifdef _MSC_VER
+#define EDGEMASKS_RESTRICT __restrict
+#else
+#define EDGEMASKS_RESTRICT __restrict__
+#endif
+
+// One plane as the kernels see it, independent of VapourSynth. Strides are in bytes. The SIMD kernels read and write whole vectors, so both
+// planes have to be 64-byte aligned with strides that are multiples of 64.
+struct EdgeMasksPlane {
+    const void* srcp;
+    void* dstp;
+    ptrdiff_t srcStride, dstStride;
+    int width, height;
+    float scale;
+    int scaleMul, scaleShift;
+    // largest integer sample value, 0 for float
+    int peak;
+    // set by setThresholds
+    bool threshold = false;
+    float thrLo = 0.0f, thrHi = 0.0f;
+    // sectors the Direction output is quantized to, 0 for the angle in radians, which only float planes can hold
+    int bins = 0;
+    // where the Signed output writes gy, at dstStride, while gx goes to dstp
+    void* dstpGy = nullptr;
+    // radius of the binomial blur the operator sees the plane through, 0-2, see binomial
+    int presmooth = 0;
+};
+
+// Processes rows [top, bottom) of one plane
+using kernel_t = void (*)(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+
+// Kernel for an operator, magnitude and sample format, with opt as in the filter's parameter (0-5). An instruction set this build was compiled
+// without falls back to C; whether the cpu supports the one asked for is up to the caller.
+kernel_t selectKernel(int op, int magnitude, int bytesPerSample, int bits, int opt) noexcept;
+
+// Name of the kernels selectKernel picks for opt
+const char* isaName(int opt) noexcept;
+
+// Processes a whole plane
+using hysteresis_t = void (*)(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, void* EDGEMASKS_RESTRICT queue) noexcept;
+
+// First pass of Canny with the gradient of op, Sobel or Scharr: magnitude, non-maximum suppression and the double threshold of thrLo and thrHi
+// in one pass over the rows. Strong edges come out at the peak, or 1.0 for float, and weak edges as 1, or 0.25 for float.
+kernel_t selectCanny(int op, int magnitude, int bytesPerSample) noexcept;
+
+// Second pass of Canny over the whole plane the first has written: keeps the weak edges connected to strong ones and clears the rest
+hysteresis_t selectHysteresis(int bytesPerSample) noexcept;
+
+// Output below lo becomes 0 and output from hi on the peak, or 1.0 for float; anything between passes through. Integer thresholds are rounded up
+// and clamped to the sample range, so that thresholding the unclamped values of the SIMD kernels agrees with the C kernel.
+void setThresholds(EdgeMasksPlane* p, float lo, float hi) noexcept;
+
+// Sets scaleMul and scaleShift from scale and peak. An integer plane gets its scale as a fixed point multiply where that rounds exactly like the
+// float path, and a scaleMul of 0 otherwise.
+void foldScale(EdgeMasksPlane* p, int op, int magnitude) noexcept;
+
+// Scratch space a kernel needs for a plane of the given width, for matrix 3 or 5
+constexpr size_t bufferSize(int width, int matrix) noexcept {
+    // ring of converted source rows plus the smoothed and differentiated rows of the separable operators, two output rows at a time, and a row
+    // of the presmoothing, each padded by one vector on either side
+    return (((width + 63) & ~63) + 64 * 2) * (matrix + 6) * sizeof(float);
+}
+
+// Scratch space of the first pass of Canny for a plane of the given width
+constexpr size_t cannyBufferSize(int width) noexcept {
+    // smoothed and differentiated rows, three rows of magnitudes and two of directions, each padded by two pixels on either side
+    return (static_cast<size_t>(width) + 4) * 7 * sizeof(float);
+}
+
+// Queue of the hysteresis for a plane of the given size, which every pixel of it may enter
+constexpr size_t hysteresisQueueSize(int width, int height) noexcept {
+    return static_cast<size_t>(width) * height * sizeof(uint32_t);
+}
+
+enum Operator {
+    Tritical,
+    Cross,
+    Prewitt,
+    Sobel,
+    Scharr,
+    RScharr,
+    Kroon,
+    Robinson3,
+    Robinson5,
+    Kirsch,
+    ExPrewitt,
+    ExSobel,
+    FDoG,
+    ExKirsch
+};
+
+enum Magnitude {
+    Euclidean,
+    L1,
+    Linf,
+    Approx,
+    // the direction of the gradient rather than its strength, see gradientAngle and angleBin
+    Direction,
+    // gx and gy themselves, scaled and offset by half the range for integer output, to dstp and dstpGy
+    Signed
+};
+
+// Divisor applied to the user's scale, which brings the operators with large weights to the range of Sobel
+constexpr int operatorNorm(int op) noexcept {
+    switch (op) {
+    case Scharr:
+        return 3;
+    case RScharr:
+        return 47;
+    case Kroon:
+        return 17;
+    case FDoG:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+// Largest absolute value of gx/gy, or of any compass direction, relative to the input peak
+constexpr int operatorGain(int op) noexcept {
+    switch (op) {
+    case Tritical:
+    case Cross:
+        return 1;
+    case Prewitt:
+    case Robinson3:
+        return 3;
+    case Sobel:
+    case Robinson5:
+        return 4;
+    case Scharr:
+        return 16;
+    case RScharr:
+        return 256;
+    case Kroon:
+        return 95;
+    case Kirsch:
+    case ExPrewitt:
+        return 15;
+    case ExSobel:
+    case FDoG:
+        return 18;
+    default:
+        return 78;
+    }
+}
+
+// Largest value held in integer lanes for an input peak: |gx|/|gy| for Euclidean and Direction, which are combined in float, and for Signed,
+// otherwise the combined magnitude.
+// Approx is max + (min >> 2) + (min >> 3), i.e. alpha = 1 and beta = 3/8.
+constexpr int magnitudeBound(int op, int magnitude, int peak) noexcept {
+    const int g = operatorGain(op) * peak;
+
+    if (magnitude == L1)
+        return g * 2;
+    else if (magnitude == Approx)
+        return g + (g >> 2) + (g >> 3);
+    else
+        return g;
+}
+
+// Width of the column strips the SIMD kernels split a plane into, so that the ring of rows they keep, bytesPerColumn per column, stays within
+// the L1 data cache at any frame width. A multiple of 64 pixels, which keeps every strip but the last whole vectors and whole cache lines wide.
+constexpr int stripWidth(int width, int bytesPerColumn) noexcept {
+    constexpr int budget = 32 * 1024;
+    const int strips = (width * bytesPerColumn + budget - 1) / budget;
+    return ((width + strips - 1) / strips + 63) & ~63;
+}
+
+constexpr bool isCompass(int op) noexcept {
+    return op == Robinson3 || op == Robinson5 || op == Kirsch || op == ExKirsch;
+}
+
+constexpr bool isSeparable(int op) noexcept {
+    return op == Prewitt || op == Sobel || op == Scharr || op == RScharr || op == Kroon || op == ExPrewitt || op == ExSobel || op == FDoG;
+}
+
+// Smoothing taps of a separable operator, read through tap(i) for i in [-radius, radius].
+// gx is the horizontal derivative of the vertically smoothed rows, gy the horizontal smoothing of the vertical derivative.
+template<int Operator, typename F>
+inline auto smooth(F&& tap) noexcept {
+    if constexpr (Operator == Prewitt)
+        return tap(-1) + tap(0) + tap(1);
+    else if constexpr (Operator == Sobel)
+        return tap(-1) + 2 * tap(0) + tap(1);
+    else if constexpr (Operator == Scharr)
+        return 3 * (tap(-1) + tap(1)) + 10 * tap(0);
+    else if constexpr (Operator == RScharr)
+        return 47 * (tap(-1) + tap(1)) + 162 * tap(0);
+    else if constexpr (Operator == Kroon)
+        return 17 * (tap(-1) + tap(1)) + 61 * tap(0);
+    else if constexpr (Operator == ExPrewitt)
+        return tap(-2) + tap(-1) + tap(0) + tap(1) + tap(2);
+    else if constexpr (Operator == ExSobel)
+        return tap(-2) + tap(-1) + 2 * tap(0) + tap(1) + tap(2);
+    else
+        return tap(-2) + tap(2) + 2 * (tap(-1) + tap(1)) + 3 * tap(0);
+}
+
+// Derivative taps of a separable operator, positive towards the top/left
+template<int Operator, typename F>
+inline auto derive(F&& tap) noexcept {
+    if constexpr (Operator == ExPrewitt || Operator == ExSobel)
+        return 2 * (tap(-2) - tap(2)) + tap(-1) - tap(1);
+    else if constexpr (Operator == FDoG)
+        return tap(-2) + tap(-1) - tap(1) - tap(2);
+    else
+        return tap(-1) - tap(1);
+}
+
+// Taps of the presmoothing, [1 2 1] for Radius 1 and [1 4 6 4 1] for Radius 2, read through tap(i) for i in [-Radius, Radius]. Applied to the
+// columns and then the rows, each pass dividing by its gain of 4 or 16 with rounding for integer input, so that the blurred plane stays in the
+// range of the input and in the lanes the operator runs in.
+template<int Radius, typename F>
+inline auto binomial(F&& tap) noexcept {
+    if constexpr (Radius == 1)
+        return tap(-1) + 2 * tap(0) + tap(1);
+    else
+        return tap(-2) + tap(2) + 4 * (tap(-1) + tap(1)) + 6 * tap(0);
+}
+
+// Angle in radians of the direction the gradient rises towards, counter-clockwise from the right and in [-pi, pi], from gx and gy as the operators
+// compute them, i.e. positive towards the left and the top. atan on [0, 1] is a polynomial good to 2e-6 radians, and the SIMD kernels repeat the
+// same operations in the same order, so that their output matches this exactly.
+inline float gradientAngle(float gx, float gy) noexcept {
+    const float gxA = std::abs(gx);
+    const float gyA = std::abs(gy);
+    const float a = std::min(gxA, gyA) / std::max(std::max(gxA, gyA), FLT_MIN);
+    const float s = a * a;
+    float r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f + s * (-0.11643287f + s * (0.05265332f + s * -0.01172120f)))));
+    r = gxA < gyA ? 1.57079633f - r : r;
+    r = 0.0f < gx ? 3.14159265f - r : r;
+    return gy < 0.0f ? -r : r;
+}
+
+// Sector of an angle among bins equal ones, numbered counter-clockwise from the one centred on the right
+inline float angleBin(float angle, int bins) noexcept {
+    const float k = std::floor(angle * (bins * 0.159154943f) + 0.5f);
+    return k < 0.0f ? k + bins : k;
+}
@@ -1,13 +1,20 @@
 #ifdef EDGEMASKS_X86
 #define INSTRSET 5
-#include "edgemasks.h"
+#include "edgemasks_kernels.h"
 
-template<typename pixel_t, int Operator, bool euclidean>
-void filterSSE4(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept {
-    using vector_t = std::conditional_t<std::is_integral_v<pixel_t>, Vec4i, Vec4f>;
+template<typename pixel_t, int Operator, int Magnitude, int Bits>
+void filterSSE4(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept {
+    // Bits is the highest bit depth the kernel accepts, 0 for float; integer input runs in 16-bit lanes whenever everything the operator produces from it fits
+    constexpr bool narrow = std::is_integral_v<pixel_t> && magnitudeBound(Operator, Magnitude, (1 << Bits) - 1) <= INT16_MAX;
+    using vector_t = std::conditional_t<narrow, Vec8s, std::conditional_t<std::is_integral_v<pixel_t>, Vec4i, Vec4f>>;
+    using scalar_t = std::conditional_t<narrow, int16_t, std::conditional_t<std::is_integral_v<pixel_t>, int32_t, float>>;
 
     auto load = [](const pixel_t* srcp) noexcept {
-        if constexpr (std::is_same_v<pixel_t, uint8_t>)
+        if constexpr (narrow && std::is_same_v<pixel_t, uint16_t>)
+            return vector_t().load(srcp);
+        else if constexpr (narrow)
+            return vector_t().load_8uc(srcp);
+        else if constexpr (std::is_same_v<pixel_t, uint8_t>)
             return vector_t().load_4uc(srcp);
         else if constexpr (std::is_same_v<pixel_t, uint16_t>)
             return vector_t().load_4us(srcp);
@@ -15,37 +22,323 @@ void filterSSE4(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRI
             return vector_t().load(srcp);
     };
 
-    auto store = [&](const vector_t& srcp, pixel_t* dstp) noexcept {
-        if constexpr (std::is_same_v<pixel_t, uint8_t>) {
+    const scalar_t thrLo = static_cast<scalar_t>(p->thrLo);
+    const scalar_t thrHi = static_cast<scalar_t>(p->thrHi);
+    const scalar_t thrTop = std::is_integral_v<pixel_t> ? p->peak : 1;
+    const bool thresholded = p->threshold;
+
+    auto store = [&](vector_t srcp, pixel_t* dstp) noexcept {
+        if (thresholded)
+            srcp = select(srcp < thrLo, vector_t(0), select(srcp >= thrHi, vector_t(thrTop), srcp));
+
+        if constexpr (narrow && std::is_same_v<pixel_t, uint16_t>) {
+            min(srcp, p->peak).store_nt(dstp);
+        } else if constexpr (narrow) {
+            const auto result = compress_saturated_s2u(srcp, zero_si128());
+            result.storel(dstp);
+        } else if constexpr (std::is_same_v<pixel_t, uint8_t>) {
             const auto result = compress_saturated_s2u(compress_saturated(srcp, zero_si128()), zero_si128());
             result.store_si32(dstp);
         } else if constexpr (std::is_same_v<pixel_t, uint16_t>) {
             const auto result = compress_saturated_s2u(srcp, zero_si128());
-            min(result, d->peak).storel(dstp);
+            min(result, p->peak).storel(dstp);
         } else {
             srcp.store_nt(dstp);
         }
     };
 
-    for (int plane = 0; plane < d->vi->format.numPlanes; plane++) {
-        if (d->process[plane]) {
-            const int width = vsapi->getFrameWidth(src, plane);
-            const int height = vsapi->getFrameHeight(src, plane);
-            const ptrdiff_t stride = vsapi->getStride(src, plane) / sizeof(pixel_t);
-            auto srcp0 = reinterpret_cast<const pixel_t*>(vsapi->getReadPtr(src, plane));
-            auto dstp = reinterpret_cast<pixel_t*>(vsapi->getWritePtr(dst, plane));
+    const int planeWidth = p->width;
+    const int height = p->height;
+    const ptrdiff_t srcStride = p->srcStride / sizeof(pixel_t);
+    const ptrdiff_t dstStride = p->dstStride / sizeof(pixel_t);
+    auto srcp0 = static_cast<const pixel_t*>(p->srcp);
+    auto dstp0 = static_cast<pixel_t*>(p->dstp) + dstStride * top;
+    auto gyp0 = static_cast<pixel_t*>(Magnitude == Signed ? p->dstpGy : p->dstp) + dstStride * top;
+
+    auto reflect = [&](int y) noexcept {
+        return y < 0 ? -y : (y >= height ? (height - 1) * 2 - y : y);
+    };
+
+    auto magnitude = [](const auto& gx, const auto& gy) noexcept {
+        if constexpr (Magnitude == Euclidean) {
+            if constexpr (std::is_integral_v<pixel_t>) {
+                const Vec4f gxF = to_float(gx);
+                const Vec4f gyF = to_float(gy);
+                return sqrt(gxF * gxF + gyF * gyF);
+            } else {
+                return sqrt(gx * gx + gy * gy);
+            }
+        } else {
+            const auto gxA = abs(gx);
+            const auto gyA = abs(gy);
+
+            if constexpr (Magnitude == L1)
+                return gxA + gyA;
+            else if constexpr (Magnitude == Linf)
+                return max(gxA, gyA);
+            else if constexpr (std::is_integral_v<pixel_t>)
+                return max(gxA, gyA) + (min(gxA, gyA) >> 2) + (min(gxA, gyA) >> 3);
+            else
+                return max(gxA, gyA) + min(gxA, gyA) * 0.375f;
+        }
+    };
+
+    auto finalize = [&](Vec4f gF) noexcept {
+        gF *= p->scale;
+
+        if constexpr (std::is_integral_v<pixel_t>)
+            return truncatei(gF + 0.5f);
+        else
+            return gF;
+    };
+
+    auto output = [&](const vector_t& g) noexcept -> vector_t {
+        if constexpr (std::is_integral_v<pixel_t>) {
+            const int mul = p->scaleMul;
+            const int shift = p->scaleShift;
+
+            if (mul == 1 && shift == 0)
+                return g;
+
+            if (mul) {
+                if constexpr (narrow) {
+                    // g * mul + rounding, pairing each 16-bit lane with a constant 1
+                    const Vec4i coeff = mul | ((1 << shift >> 1) << 16);
+                    const Vec4i lo = Vec4i(_mm_madd_epi16(_mm_unpacklo_epi16(g, Vec8s(1)), coeff)) >> shift;
+                    const Vec4i hi = Vec4i(_mm_madd_epi16(_mm_unpackhi_epi16(g, Vec8s(1)), coeff)) >> shift;
+                    return _mm_packs_epi32(lo, hi);
+                } else {
+                    return (g * mul + (1 << shift >> 1)) >> shift;
+                }
+            }
+        }
+
+        if constexpr (narrow)
+            return compress_saturated(finalize(to_float(extend_low(g))), finalize(to_float(extend_high(g))));
+        else if constexpr (std::is_integral_v<pixel_t>)
+            return finalize(to_float(g));
+        else
+            return finalize(g);
+    };
+
+    // gradientAngle and angleBin, operation for operation
+    const float binScale = p->bins * 0.159154943f;
+
+    auto direction = [&](const Vec4f& gx, const Vec4f& gy) noexcept {
+        const Vec4f gxA = abs(gx);
+        const Vec4f gyA = abs(gy);
+        const Vec4f a = min(gxA, gyA) / max(max(gxA, gyA), FLT_MIN);
+        const Vec4f s = a * a;
+        Vec4f r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f + s * (-0.11643287f + s * (0.05265332f + s * -0.01172120f)))));
+        r = select(gxA < gyA, 1.57079633f - r, r);
+        r = select(0.0f < gx, 3.14159265f - r, r);
+        r = select(gy < 0.0f, -r, r);
+
+        if constexpr (std::is_integral_v<pixel_t>) {
+            const Vec4f k = floor(r * binScale + 0.5f);
+            return truncatei(select(k < 0.0f, k + static_cast<float>(p->bins), k));
+        } else {
+            if (!p->bins)
+                return r;
+
+            const Vec4f k = floor(r * binScale + 0.5f);
+            return select(k < 0.0f, k + static_cast<float>(p->bins), k);
+        }
+    };
+
+    // gx or gy for Signed, as in filterC
+    const int half = (p->peak + 1) >> 1;
+    const float bias = half + 0.5f;
+
+    auto offset = [&](const vector_t& g) noexcept -> vector_t {
+        if constexpr (narrow) {
+            if (p->scaleMul == 1 && p->scaleShift == 0)
+                return max(add_saturated(g, vector_t(half)), vector_t(0));
+            else
+                return max(compress_saturated(truncatei(to_float(extend_low(g)) * p->scale + bias), truncatei(to_float(extend_high(g)) * p->scale + bias)), vector_t(0));
+        } else if constexpr (std::is_integral_v<pixel_t>) {
+            if (p->scaleMul == 1 && p->scaleShift == 0)
+                return max(g + half, vector_t(0));
+            else
+                return max(truncatei(to_float(g) * p->scale + bias), vector_t(0));
+        } else {
+            return g * p->scale;
+        }
+    };
+
+    auto gradient = [&](const vector_t& gx, const vector_t& gy) noexcept {
+        if constexpr (Magnitude == Direction) {
+            if constexpr (narrow)
+                return compress_saturated(direction(to_float(extend_low(gx)), to_float(extend_low(gy))), direction(to_float(extend_high(gx)), to_float(extend_high(gy))));
+            else if constexpr (std::is_integral_v<pixel_t>)
+                return direction(to_float(gx), to_float(gy));
+            else
+                return direction(gx, gy);
+        } else if constexpr (Magnitude == Signed) {
+            return std::pair(offset(gx), offset(gy));
+        } else if constexpr (Magnitude != Euclidean)
+            return output(magnitude(gx, gy));
+        else if constexpr (narrow)
+            return compress_saturated(finalize(magnitude(extend_low(gx), extend_low(gy))), finalize(magnitude(extend_high(gx), extend_high(gy))));
+        else
+            return finalize(magnitude(gx, gy));
+    };
+
+    // stores an output of gradient, which for Signed is gx to dstp and gy to the same place in the plane of gy
+    auto put = [&](const auto& g, pixel_t* dstp, pixel_t* gyp) noexcept {
+        if constexpr (Magnitude == Signed) {
+            store(g.first, dstp);
+            store(g.second, gyp);
+        } else {
+            store(g, dstp);
+        }
+    };
+
+    // output rows produced per pass over the ring
+    constexpr int block = 2;
+    constexpr int radius = (Operator == ExPrewitt || Operator == ExSobel || Operator == FDoG || Operator == ExKirsch) ? 2 : 1;
+    const int tileWidth = stripWidth(planeWidth, (radius * 2 + block * (isSeparable(Operator) ? 3 : 1) + (p->presmooth ? 1 : 0)) * sizeof(scalar_t));
+
+    // wide planes are processed in column strips. the rows of a strip carry a vector of the neighbouring strips' columns on either side, so
+    // only the edges of the plane are mirrored. a last strip narrower than the radius is merged into the one before, so that every column a
+    // strip borrows exists
+    for (int left = 0, width; left < planeWidth; left += width) {
+        width = planeWidth - left - tileWidth < radius ? planeWidth - left : tileWidth;
+        const int paddedWidth = (width + vector_t().size() - 1) & ~(vector_t().size() - 1);
+        const ptrdiff_t bufferStride = paddedWidth + vector_t().size() * 2;
+        const int begin = left > 0 ? -vector_t().size() : 0;
+        const int end = left + width < planeWidth ? paddedWidth + vector_t().size() : paddedWidth;
+        auto dstp = dstp0 + left;
+        auto gyp = gyp0 + left;
+
+        scalar_t* rows[radius * 2 + block];
+        for (int i = 0; i < radius * 2 + block; i++)
+            rows[i] = reinterpret_cast<scalar_t*>(buffer) + bufferStride * i + vector_t().size();
+
+        scalar_t* blurred = reinterpret_cast<scalar_t*>(buffer) + bufferStride * (radius * 2 + block * 3) + vector_t().size();
+
+        // row y of the plane blurred by the binomial of radius presmooth, the columns first into blurred and then across them into row
+        auto presmoothed = [&](int y, scalar_t* EDGEMASKS_RESTRICT row, auto blur) noexcept {
+            constexpr int reach = decltype(blur)::value;
+
+            // sums of 12-bit input overflow 16-bit lanes but not their unsigned range, which the mask restores after the shift
+            auto normalize = [](const vector_t& sum) noexcept -> vector_t {
+                if constexpr (narrow)
+                    return ((sum + (1 << reach * 2 >> 1)) >> (reach * 2)) & vector_t(0xFFFF >> (reach * 2));
+                else if constexpr (std::is_integral_v<pixel_t>)
+                    return (sum + (1 << reach * 2 >> 1)) >> (reach * 2);
+                else
+                    return sum * (1.0f / (1 << reach * 2));
+            };
+
+            const pixel_t* taps[reach * 2 + 1];
+            for (int i = -reach; i <= reach; i++)
+                taps[reach + i] = srcp0 + srcStride * reflect(reflect(y) + i) + left;
+
+            for (int x = begin; x < end; x += vector_t().size())
+                normalize(binomial<reach>([&](int i) noexcept { return load(taps[reach + i] + x); })).store_a(blurred + x);
+
+            for (int i = 1; i <= reach; i++) {
+                if (left == 0)
+                    blurred[-i] = blurred[i];
+
+                if (left + width == planeWidth)
+                    blurred[width - 1 + i] = blurred[width - 1 - i];
+            }
+
+            for (int x = begin; x < end; x += vector_t().size())
+                normalize(binomial<reach>([&](int i) noexcept { return vector_t().load(blurred + x + i); })).store_a(row + x);
+        };
+
+        auto convert = [&](int y, scalar_t* EDGEMASKS_RESTRICT row) noexcept {
+            if (p->presmooth == 1) {
+                presmoothed(y, row, std::integral_constant<int, 1>());
+                return;
+            } else if (p->presmooth == 2) {
+                presmoothed(y, row, std::integral_constant<int, 2>());
+                return;
+            }
+
+            auto srcp = srcp0 + srcStride * reflect(y) + left;
+
+            for (int x = begin; x < end; x += vector_t().size())
+                load(srcp + x).store_a(row + x);
+        };
+
+        auto mirror = [&](scalar_t* EDGEMASKS_RESTRICT row) noexcept {
+            for (int i = 1; i <= radius; i++) {
+                if (left == 0)
+                    row[-i] = row[i];
+
+                if (left + width == planeWidth)
+                    row[width - 1 + i] = row[width - 1 - i];
+            }
+        };
+
+        auto advance = [&](int y) noexcept {
+            std::rotate(rows, rows + block, rows + radius * 2 + block);
+
+            for (int i = 0; i < block; i++) {
+                convert(y + block + radius + i, rows[radius * 2 + i]);
 
+                if constexpr (!isSeparable(Operator))
+                    mirror(rows[radius * 2 + i]);
+            }
+        };
+
+        for (int i = 0; i < radius * 2 + block; i++) {
+            convert(top + i - radius, rows[i]);
+
+            if constexpr (!isSeparable(Operator))
+                mirror(rows[i]);
+        }
+
+        if constexpr (isSeparable(Operator)) {
+            scalar_t* smoothed[block];
+            scalar_t* derived[block];
+            for (int i = 0; i < block; i++) {
+                smoothed[i] = reinterpret_cast<scalar_t*>(buffer) + bufferStride * (radius * 2 + block + i) + vector_t().size();
+                derived[i] = reinterpret_cast<scalar_t*>(buffer) + bufferStride * (radius * 2 + block * 2 + i) + vector_t().size();
+            }
+
+            for (int y = top; y < bottom; y += block) {
+                for (int x = begin; x < end; x += vector_t().size()) {
+                    vector_t column[radius * 2 + block];
+                    for (int i = 0; i < radius * 2 + block; i++)
+                        column[i] = vector_t().load_a(rows[i] + x);
+
+                    for (int i = 0; i < block; i++) {
+                        smooth<Operator>([&](int j) noexcept { return column[radius + i + j]; }).store_a(smoothed[i] + x);
+                        derive<Operator>([&](int j) noexcept { return column[radius + i + j]; }).store_a(derived[i] + x);
+                    }
+                }
+
+                for (int i = 0; i < block && y + i < bottom; i++) {
+                    mirror(smoothed[i]);
+                    mirror(derived[i]);
+
+                    for (int x = 0; x < width; x += vector_t().size()) {
+                        const vector_t gx = derive<Operator>([&](int j) noexcept { return vector_t().load(smoothed[i] + x + j); });
+                        const vector_t gy = smooth<Operator>([&](int j) noexcept { return vector_t().load(derived[i] + x + j); });
+                        put(gradient(gx, gy), dstp + x, gyp + x);
+                    }
+
+                    dstp += dstStride;
+                    gyp += dstStride;
+                }
+
+                if (y + block < bottom)
+                    advance(y);
+            }
+        } else {
             vector_t a00, a01, a02, a03, a04;
             vector_t a10, a11, a12, a13, a14;
             vector_t a20, a21, a22, a23, a24;
             vector_t a30, a31, a32, a33, a34;
             vector_t a40, a41, a42, a43, a44;
 
-            const int regularPart = (width - 1) & ~(vector_t().size() - 1);
-
             auto detect = [&]() noexcept {
                 vector_t gx, gy, g;
-                Vec4f gxF, gyF, gF;
 
                 if constexpr (Operator == Tritical) {
                     gx = a10 - a12;
@@ -53,253 +346,372 @@ void filterSSE4(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRI
                 } else if constexpr (Operator == Cross) {
                     gx = a00 - a22;
                     gy = a02 - a20;
-                } else if constexpr (Operator == Prewitt) {
-                    gx = a00 + a10 + a20 - a02 - a12 - a22;
-                    gy = a00 + a01 + a02 - a20 - a21 - a22;
-                } else if constexpr (Operator == Sobel) {
-                    gx = a00 + 2 * a10 + a20 - a02 - 2 * a12 - a22;
-                    gy = a00 + 2 * a01 + a02 - a20 - 2 * a21 - a22;
-                } else if constexpr (Operator == Scharr) {
-                    gx = 3 * (a00 + a20) + 10 * a10 - 3 * (a02 + a22) - 10 * a12;
-                    gy = 3 * (a00 + a02) + 10 * a01 - 3 * (a20 + a22) - 10 * a21;
-                } else if constexpr (Operator == RScharr) {
-                    gx = 47 * (a00 + a20) + 162 * a10 - 47 * (a02 + a22) - 162 * a12;
-                    gy = 47 * (a00 + a02) + 162 * a01 - 47 * (a20 + a22) - 162 * a21;
-                } else if constexpr (Operator == Kroon) {
-                    gx = 17 * (a00 + a20) + 61 * a10 - 17 * (a02 + a22) - 61 * a12;
-                    gy = 17 * (a00 + a02) + 61 * a01 - 17 * (a20 + a22) - 61 * a21;
                 } else if constexpr (Operator == Robinson3) {
-                    const vector_t g1 = a02 + a01 + a00 - a20 - a21 - a22;
-                    const vector_t g2 = a01 + a00 + a10 - a21 - a22 - a12;
-                    const vector_t g3 = a00 + a10 + a20 - a22 - a12 - a02;
-                    const vector_t g4 = a10 + a20 + a21 - a12 - a02 - a01;
+                    const vector_t e0 = a02 - a20;
+                    const vector_t e1 = a01 - a21;
+                    const vector_t e2 = a00 - a22;
+                    const vector_t e3 = a10 - a12;
+                    const vector_t g1 = e0 + e1 + e2;
+                    const vector_t g2 = g1 + e3 - e0;
+                    const vector_t g3 = g2 - e0 - e1;
+                    const vector_t g4 = g3 - e1 - e2;
                     g = max(max(abs(g1), abs(g2)), max(abs(g3), abs(g4)));
                 } else if constexpr (Operator == Robinson5) {
-                    const vector_t g1 = a02 + 2 * a01 + a00 - a20 - 2 * a21 - a22;
-                    const vector_t g2 = a01 + 2 * a00 + a10 - a21 - 2 * a22 - a12;
-                    const vector_t g3 = a00 + 2 * a10 + a20 - a22 - 2 * a12 - a02;
-                    const vector_t g4 = a10 + 2 * a20 + a21 - a12 - 2 * a02 - a01;
+                    const vector_t e0 = a02 - a20;
+                    const vector_t e1 = a01 - a21;
+                    const vector_t e2 = a00 - a22;
+                    const vector_t e3 = a10 - a12;
+                    const vector_t s0 = e0 + e1;
+                    const vector_t s1 = e1 + e2;
+                    const vector_t s2 = e2 + e3;
+                    const vector_t s3 = e3 - e0;
+                    const vector_t g1 = s0 + s1;
+                    const vector_t g2 = s1 + s2;
+                    const vector_t g3 = s2 + s3;
+                    const vector_t g4 = s3 - s0;
                     g = max(max(abs(g1), abs(g2)), max(abs(g3), abs(g4)));
                 } else if constexpr (Operator == Kirsch) {
-                    const vector_t g1 = 5 * (a02 + a01 + a00) - 3 * (a10 + a20 + a21 + a22 + a12);
-                    const vector_t g2 = 5 * (a01 + a00 + a10) - 3 * (a20 + a21 + a22 + a12 + a02);
-                    const vector_t g3 = 5 * (a00 + a10 + a20) - 3 * (a21 + a22 + a12 + a02 + a01);
-                    const vector_t g4 = 5 * (a10 + a20 + a21) - 3 * (a22 + a12 + a02 + a01 + a00);
-                    const vector_t g5 = 5 * (a20 + a21 + a22) - 3 * (a12 + a02 + a01 + a00 + a10);
-                    const vector_t g6 = 5 * (a21 + a22 + a12) - 3 * (a02 + a01 + a00 + a10 + a20);
-                    const vector_t g7 = 5 * (a22 + a12 + a02) - 3 * (a01 + a00 + a10 + a20 + a21);
-                    const vector_t g8 = 5 * (a12 + a02 + a01) - 3 * (a00 + a10 + a20 + a21 + a22);
+                    // walk the rim clockwise: each direction differs from the previous one by the pixel entering and the pixel leaving the positive arc
+                    const vector_t rim = a02 + a01 + a00 + a10 + a20 + a21 + a22 + a12;
+                    const vector_t g1 = 8 * (a02 + a01 + a00) - 3 * rim;
+                    const vector_t g2 = g1 + 8 * (a10 - a02);
+                    const vector_t g3 = g2 + 8 * (a20 - a01);
+                    const vector_t g4 = g3 + 8 * (a21 - a00);
+                    const vector_t g5 = g4 + 8 * (a22 - a10);
+                    const vector_t g6 = g5 + 8 * (a12 - a20);
+                    const vector_t g7 = g6 + 8 * (a02 - a21);
+                    const vector_t g8 = g7 + 8 * (a01 - a22);
                     g = max(max(max(abs(g1), abs(g2)), max(abs(g3), abs(g4))), max(max(abs(g5), abs(g6)), max(abs(g7), abs(g8))));
-                } else if constexpr (Operator == ExPrewitt) {
-                    gx = 2 * (a00 + a10 + a20 + a30 + a40) + a01 + a11 + a21 + a31 + a41
-                        - a03 - a13 - a23 - a33 - a43 - 2 * (a04 + a14 + a24 + a34 + a44);
-                    gy = 2 * (a00 + a01 + a02 + a03 + a04) + a10 + a11 + a12 + a13 + a14
-                        - a30 - a31 - a32 - a33 - a34 - 2 * (a40 + a41 + a42 + a43 + a44);
-                } else if constexpr (Operator == ExSobel) {
-                    gx = 2 * (a00 + a10 + a30 + a40) + 4 * a20 + a01 + a11 + 2 * a21 + a31 + a41
-                        - a03 - a13 - 2 * a23 - a33 - a43 - 2 * (a04 + a14 + a34 + a44) - 4 * a24;
-                    gy = 2 * (a00 + a01 + a03 + a04) + 4 * a02 + a10 + a11 + 2 * a12 + a13 + a14
-                        - a30 - a31 - 2 * a32 - a33 - a34 - 2 * (a40 + a41 + a43 + a44) - 4 * a42;
-                } else if constexpr (Operator == FDoG) {
-                    gx = a00 + a01 + a40 + a41 + 2 * (a10 + a11 + a30 + a31) + 3 * (a20 + a21)
-                        - a03 - a04 - a43 - a44 - 2 * (a13 + a14 + a33 + a34) - 3 * (a23 + a24);
-                    gy = a00 + a10 + a04 + a14 + 2 * (a01 + a11 + a03 + a13) + 3 * (a02 + a12)
-                        - a30 - a40 - a34 - a44 - 2 * (a31 + a41 + a33 + a43) - 3 * (a32 + a42);
                 } else if constexpr (Operator == ExKirsch) {
-                    const vector_t g1 = 9 * (a14 + a04 + a03 + a02 + a01 + a00 + a10) - 7 * (a20 + a30 + a40 + a41 + a42 + a43 + a44 + a34 + a24)
-                        + 5 * (a13 + a12 + a11) - 3 * (a21 + a31 + a32 + a33 + a23);
-                    const vector_t g2 = 9 * (a03 + a02 + a01 + a00 + a10 + a20 + a30) - 7 * (a40 + a41 + a42 + a43 + a44 + a34 + a24 + a14 + a04)
-                        + 5 * (a12 + a11 + a21) - 3 * (a31 + a32 + a33 + a23 + a13);
-                    const vector_t g3 = 9 * (a01 + a00 + a10 + a20 + a30 + a40 + a41) - 7 * (a42 + a43 + a44 + a34 + a24 + a14 + a04 + a03 + a02)
-                        + 5 * (a11 + a21 + a31) - 3 * (a32 + a33 + a23 + a13 + a12);
-                    const vector_t g4 = 9 * (a10 + a20 + a30 + a40 + a41 + a42 + a43) - 7 * (a44 + a34 + a24 + a14 + a04 + a03 + a02 + a01 + a00)
-                        + 5 * (a21 + a31 + a32) - 3 * (a33 + a23 + a13 + a12 + a11);
-                    const vector_t g5 = 9 * (a30 + a40 + a41 + a42 + a43 + a44 + a34) - 7 * (a24 + a14 + a04 + a03 + a02 + a01 + a00 + a10 + a20)
-                        + 5 * (a31 + a32 + a33) - 3 * (a23 + a13 + a12 + a11 + a21);
-                    const vector_t g6 = 9 * (a41 + a42 + a43 + a44 + a34 + a24 + a14) - 7 * (a04 + a03 + a02 + a01 + a00 + a10 + a20 + a30 + a40)
-                        + 5 * (a32 + a33 + a23) - 3 * (a13 + a12 + a11 + a21 + a31);
-                    const vector_t g7 = 9 * (a43 + a44 + a34 + a24 + a14 + a04 + a03) - 7 * (a02 + a01 + a00 + a10 + a20 + a30 + a40 + a41 + a42)
-                        + 5 * (a33 + a23 + a13) - 3 * (a12 + a11 + a21 + a31 + a32);
-                    const vector_t g8 = 9 * (a34 + a24 + a14 + a04 + a03 + a02 + a01) - 7 * (a00 + a10 + a20 + a30 + a40 + a41 + a42 + a43 + a44)
-                        + 5 * (a23 + a13 + a12) - 3 * (a11 + a21 + a31 + a32 + a33);
+                    // same walk on both rings: the positive arc advances by two outer and one inner pixel per direction
+                    const vector_t outer = a14 + a04 + a03 + a02 + a01 + a00 + a10 + a20 + a30 + a40 + a41 + a42 + a43 + a44 + a34 + a24;
+                    const vector_t inner = a13 + a12 + a11 + a21 + a31 + a32 + a33 + a23;
+                    const vector_t g1 = 16 * (a14 + a04 + a03 + a02 + a01 + a00 + a10) - 7 * outer + 8 * (a13 + a12 + a11) - 3 * inner;
+                    const vector_t g2 = g1 + 8 * (2 * (a20 + a30 - a14 - a04) + a21 - a13);
+                    const vector_t g3 = g2 + 8 * (2 * (a40 + a41 - a03 - a02) + a31 - a12);
+                    const vector_t g4 = g3 + 8 * (2 * (a42 + a43 - a01 - a00) + a32 - a11);
+                    const vector_t g5 = g4 + 8 * (2 * (a44 + a34 - a10 - a20) + a33 - a21);
+                    const vector_t g6 = g5 + 8 * (2 * (a24 + a14 - a30 - a40) + a23 - a31);
+                    const vector_t g7 = g6 + 8 * (2 * (a04 + a03 - a41 - a42) + a13 - a32);
+                    const vector_t g8 = g7 + 8 * (2 * (a02 + a01 - a43 - a44) + a12 - a33);
                     g = max(max(max(abs(g1), abs(g2)), max(abs(g3), abs(g4))), max(max(abs(g5), abs(g6)), max(abs(g7), abs(g8))));
                 }
 
-                if constexpr (std::is_integral_v<pixel_t>) {
-                    if constexpr (euclidean) {
-                        gxF = to_float(gx);
-                        gyF = to_float(gy);
-                    } else {
-                        gF = to_float(g);
-                    }
-                } else {
-                    if constexpr (euclidean) {
-                        gxF = gx;
-                        gyF = gy;
-                    } else {
-                        gF = g;
-                    }
-                }
-
-                if constexpr (euclidean)
-                    gF = sqrt(gxF * gxF + gyF * gyF);
-
-                gF *= d->scale[plane];
-
-                if constexpr (std::is_integral_v<pixel_t>)
-                    return truncatei(gF + 0.5f);
+                if constexpr (isCompass(Operator))
+                    return output(g);
                 else
-                    return gF;
+                    return gradient(gx, gy);
             };
 
-            for (int y = 0; y < height; y++) {
-                auto prev1 = (y == 0) ? srcp0 + stride : srcp0 - stride;
-                auto next1 = (y == height - 1) ? srcp0 - stride : srcp0 + stride;
-
-                if (d->matrix == 3) {
-                    a01 = load(prev1);
-                    a11 = load(srcp0);
-                    a21 = load(next1);
-
-                    a00 = permute4<1, 0, 1, 2>(a01);
-                    a10 = permute4<1, 0, 1, 2>(a11);
-                    a20 = permute4<1, 0, 1, 2>(a21);
-
-                    if (width > vector_t().size()) {
-                        a02 = load(prev1 + 1);
-                        a12 = load(srcp0 + 1);
-                        a22 = load(next1 + 1);
-                    } else {
-                        a02 = permute4<1, 2, 3, 2>(a01);
-                        a12 = permute4<1, 2, 3, 2>(a11);
-                        a22 = permute4<1, 2, 3, 2>(a21);
-                    }
-
-                    store(detect(), dstp);
-
-                    for (int x = vector_t().size(); x < regularPart; x += vector_t().size()) {
-                        a00 = load(prev1 + x - 1); a01 = load(prev1 + x); a02 = load(prev1 + x + 1);
-                        a10 = load(srcp0 + x - 1); a11 = load(srcp0 + x); a12 = load(srcp0 + x + 1);
-                        a20 = load(next1 + x - 1); a21 = load(next1 + x); a22 = load(next1 + x + 1);
-
-                        store(detect(), dstp + x);
-                    }
-
-                    if (regularPart >= vector_t().size()) {
-                        a00 = load(prev1 + regularPart - 1); a01 = load(prev1 + regularPart); a02 = permute4<1, 2, 3, 2>(a01);
-                        a10 = load(srcp0 + regularPart - 1); a11 = load(srcp0 + regularPart); a12 = permute4<1, 2, 3, 2>(a11);
-                        a20 = load(next1 + regularPart - 1); a21 = load(next1 + regularPart); a22 = permute4<1, 2, 3, 2>(a21);
-
-                        store(detect(), dstp + regularPart);
-                    }
+            auto gather = [&](scalar_t* const* window, int x) noexcept {
+                if constexpr (radius == 1) {
+                    a00 = vector_t().load(window[0] + x - 1); a01 = vector_t().load_a(window[0] + x); a02 = vector_t().load(window[0] + x + 1);
+                    a10 = vector_t().load(window[1] + x - 1); a11 = vector_t().load_a(window[1] + x); a12 = vector_t().load(window[1] + x + 1);
+                    a20 = vector_t().load(window[2] + x - 1); a21 = vector_t().load_a(window[2] + x); a22 = vector_t().load(window[2] + x + 1);
                 } else {
-                    auto prev2 = (y == 0) ? srcp0 + stride * 2 : (y == 1 ? srcp0 : srcp0 - stride * 2);
-                    auto next2 = (y == height - 1) ? srcp0 - stride * 2 : (y == height - 2 ? srcp0 : srcp0 + stride * 2);
-
-                    a02 = load(prev2);
-                    a12 = load(prev1);
-                    a22 = load(srcp0);
-                    a32 = load(next1);
-                    a42 = load(next2);
-
-                    a00 = permute4<2, 1, 0, 1>(a02); a01 = permute4<1, 0, 1, 2>(a02);
-                    a10 = permute4<2, 1, 0, 1>(a12); a11 = permute4<1, 0, 1, 2>(a12);
-                    a20 = permute4<2, 1, 0, 1>(a22); a21 = permute4<1, 0, 1, 2>(a22);
-                    a30 = permute4<2, 1, 0, 1>(a32); a31 = permute4<1, 0, 1, 2>(a32);
-                    a40 = permute4<2, 1, 0, 1>(a42); a41 = permute4<1, 0, 1, 2>(a42);
-
-                    if (width > vector_t().size()) {
-                        a03 = load(prev2 + 1); a04 = load(prev2 + 2);
-                        a13 = load(prev1 + 1); a14 = load(prev1 + 2);
-                        a23 = load(srcp0 + 1); a24 = load(srcp0 + 2);
-                        a33 = load(next1 + 1); a34 = load(next1 + 2);
-                        a43 = load(next2 + 1); a44 = load(next2 + 2);
-                    } else {
-                        a03 = permute4<1, 2, 3, 2>(a02); a04 = permute4<2, 3, 2, 1>(a02);
-                        a13 = permute4<1, 2, 3, 2>(a12); a14 = permute4<2, 3, 2, 1>(a12);
-                        a23 = permute4<1, 2, 3, 2>(a22); a24 = permute4<2, 3, 2, 1>(a22);
-                        a33 = permute4<1, 2, 3, 2>(a32); a34 = permute4<2, 3, 2, 1>(a32);
-                        a43 = permute4<1, 2, 3, 2>(a42); a44 = permute4<2, 3, 2, 1>(a42);
-                    }
-
-                    store(detect(), dstp);
+                    a00 = vector_t().load(window[0] + x - 2); a01 = vector_t().load(window[0] + x - 1); a02 = vector_t().load_a(window[0] + x); a03 = vector_t().load(window[0] + x + 1); a04 = vector_t().load(window[0] + x + 2);
+                    a10 = vector_t().load(window[1] + x - 2); a11 = vector_t().load(window[1] + x - 1); a12 = vector_t().load_a(window[1] + x); a13 = vector_t().load(window[1] + x + 1); a14 = vector_t().load(window[1] + x + 2);
+                    a20 = vector_t().load(window[2] + x - 2); a21 = vector_t().load(window[2] + x - 1); a22 = vector_t().load_a(window[2] + x); a23 = vector_t().load(window[2] + x + 1); a24 = vector_t().load(window[2] + x + 2);
+                    a30 = vector_t().load(window[3] + x - 2); a31 = vector_t().load(window[3] + x - 1); a32 = vector_t().load_a(window[3] + x); a33 = vector_t().load(window[3] + x + 1); a34 = vector_t().load(window[3] + x + 2);
+                    a40 = vector_t().load(window[4] + x - 2); a41 = vector_t().load(window[4] + x - 1); a42 = vector_t().load_a(window[4] + x); a43 = vector_t().load(window[4] + x + 1); a44 = vector_t().load(window[4] + x + 2);
+                }
+            };
 
-                    for (int x = vector_t().size(); x < regularPart; x += vector_t().size()) {
-                        a00 = load(prev2 + x - 2); a01 = load(prev2 + x - 1); a02 = load(prev2 + x); a03 = load(prev2 + x + 1); a04 = load(prev2 + x + 2);
-                        a10 = load(prev1 + x - 2); a11 = load(prev1 + x - 1); a12 = load(prev1 + x); a13 = load(prev1 + x + 1); a14 = load(prev1 + x + 2);
-                        a20 = load(srcp0 + x - 2); a21 = load(srcp0 + x - 1); a22 = load(srcp0 + x); a23 = load(srcp0 + x + 1); a24 = load(srcp0 + x + 2);
-                        a30 = load(next1 + x - 2); a31 = load(next1 + x - 1); a32 = load(next1 + x); a33 = load(next1 + x + 1); a34 = load(next1 + x + 2);
-                        a40 = load(next2 + x - 2); a41 = load(next2 + x - 1); a42 = load(next2 + x); a43 = load(next2 + x + 1); a44 = load(next2 + x + 2);
+            for (int y = top; y < bottom; y += block) {
+                const int rowsLeft = std::min(bottom - y, block);
 
-                        store(detect(), dstp + x);
+                for (int x = 0; x < width; x += vector_t().size()) {
+                    // each window loads all of its taps, also those of the rows it shares with the other window of the block. they come from L1,
+                    // and loading the block's rows once to build both windows from them measured slower on avx2 and avx512
+                    decltype(detect()) g[block];
+                    for (int i = 0; i < block; i++) {
+                        gather(rows + i, x);
+                        g[i] = detect();
                     }
 
-                    if (regularPart >= vector_t().size()) {
-                        a00 = load(prev2 + regularPart - 2); a01 = load(prev2 + regularPart - 1); a02 = load(prev2 + regularPart);
-                        a10 = load(prev1 + regularPart - 2); a11 = load(prev1 + regularPart - 1); a12 = load(prev1 + regularPart);
-                        a20 = load(srcp0 + regularPart - 2); a21 = load(srcp0 + regularPart - 1); a22 = load(srcp0 + regularPart);
-                        a30 = load(next1 + regularPart - 2); a31 = load(next1 + regularPart - 1); a32 = load(next1 + regularPart);
-                        a40 = load(next2 + regularPart - 2); a41 = load(next2 + regularPart - 1); a42 = load(next2 + regularPart);
-
-                        a03 = permute4<1, 2, 3, 2>(a02); a04 = permute4<2, 3, 2, 1>(a02);
-                        a13 = permute4<1, 2, 3, 2>(a12); a14 = permute4<2, 3, 2, 1>(a12);
-                        a23 = permute4<1, 2, 3, 2>(a22); a24 = permute4<2, 3, 2, 1>(a22);
-                        a33 = permute4<1, 2, 3, 2>(a32); a34 = permute4<2, 3, 2, 1>(a32);
-                        a43 = permute4<1, 2, 3, 2>(a42); a44 = permute4<2, 3, 2, 1>(a42);
-
-                        store(detect(), dstp + regularPart);
-                    }
+                    for (int i = 0; i < rowsLeft; i++)
+                        put(g[i], dstp + dstStride * i + x, gyp + dstStride * i + x);
                 }
 
-                srcp0 += stride;
-                dstp += stride;
+                if (y + block < bottom)
+                    advance(y);
+
+                dstp += dstStride * block;
+                gyp += dstStride * block;
             }
         }
     }
 }
 
-template void filterSSE4<uint8_t, Tritical, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, Cross, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, Prewitt, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, Sobel, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, Scharr, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, RScharr, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, Kroon, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, Robinson3, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, Robinson5, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, Kirsch, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, ExPrewitt, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, ExSobel, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, FDoG, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint8_t, ExKirsch, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-
-template void filterSSE4<uint16_t, Tritical, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, Cross, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, Prewitt, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, Sobel, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, Scharr, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, RScharr, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, Kroon, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, Robinson3, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, Robinson5, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, Kirsch, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, ExPrewitt, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, ExSobel, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, FDoG, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<uint16_t, ExKirsch, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-
-template void filterSSE4<float, Tritical, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, Cross, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, Prewitt, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, Sobel, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, Scharr, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, RScharr, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, Kroon, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, Robinson3, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, Robinson5, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, Kirsch, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, ExPrewitt, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, ExSobel, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, FDoG, true>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
-template void filterSSE4<float, ExKirsch, false>(const VSFrame* src, VSFrame* dst, const EdgeMasksData* VS_RESTRICT d, const VSAPI* vsapi) noexcept;
+template void filterSSE4<uint8_t, Tritical, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Tritical, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Tritical, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Tritical, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Tritical, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Tritical, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Cross, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Cross, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Cross, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Cross, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Cross, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Cross, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Prewitt, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Prewitt, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Prewitt, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Prewitt, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Prewitt, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Prewitt, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Sobel, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Sobel, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Sobel, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Sobel, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Sobel, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Sobel, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Scharr, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Scharr, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Scharr, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Scharr, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Scharr, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Scharr, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, RScharr, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, RScharr, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, RScharr, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, RScharr, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, RScharr, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, RScharr, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Kroon, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Kroon, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Kroon, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Kroon, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Kroon, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Kroon, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Robinson3, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Robinson5, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, Kirsch, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExPrewitt, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExPrewitt, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExPrewitt, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExPrewitt, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExPrewitt, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExPrewitt, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExSobel, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExSobel, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExSobel, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExSobel, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExSobel, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExSobel, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, FDoG, Euclidean, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, FDoG, L1, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, FDoG, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, FDoG, Approx, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, FDoG, Direction, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, FDoG, Signed, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint8_t, ExKirsch, Linf, 8>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+
+template void filterSSE4<uint16_t, Tritical, Euclidean, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, L1, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Approx, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Direction, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Signed, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Euclidean, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, L1, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Approx, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Direction, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Signed, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Euclidean, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, L1, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Approx, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Direction, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Signed, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Euclidean, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, L1, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Approx, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Direction, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Signed, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Euclidean, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, L1, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Approx, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Direction, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Signed, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Robinson3, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Robinson5, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Kirsch, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Euclidean, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, L1, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Approx, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Direction, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Signed, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Euclidean, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Approx, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Direction, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Signed, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Euclidean, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Linf, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Approx, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Direction, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Signed, 10>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+
+template void filterSSE4<uint16_t, Tritical, Euclidean, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, L1, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Linf, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Approx, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Direction, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Signed, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Euclidean, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, L1, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Linf, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Approx, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Direction, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Signed, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Euclidean, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, L1, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Linf, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Approx, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Direction, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Signed, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Euclidean, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, L1, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Linf, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Approx, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Direction, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Signed, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Robinson3, Linf, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Robinson5, Linf, 12>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+
+template void filterSSE4<uint16_t, Tritical, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Tritical, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Cross, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Prewitt, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Sobel, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Scharr, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, RScharr, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, RScharr, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, RScharr, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, RScharr, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, RScharr, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, RScharr, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Kroon, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Kroon, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Kroon, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Kroon, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Kroon, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Kroon, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Robinson3, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Robinson5, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, Kirsch, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExPrewitt, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExSobel, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Euclidean, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, L1, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Approx, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Direction, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, FDoG, Signed, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<uint16_t, ExKirsch, Linf, 16>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+
+template void filterSSE4<float, Tritical, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Tritical, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Tritical, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Tritical, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Tritical, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Tritical, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Cross, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Cross, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Cross, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Cross, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Cross, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Cross, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Prewitt, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Prewitt, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Prewitt, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Prewitt, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Prewitt, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Prewitt, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Sobel, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Sobel, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Sobel, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Sobel, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Sobel, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Sobel, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Scharr, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Scharr, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Scharr, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Scharr, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Scharr, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Scharr, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, RScharr, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, RScharr, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, RScharr, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, RScharr, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, RScharr, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, RScharr, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Kroon, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Kroon, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Kroon, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Kroon, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Kroon, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Kroon, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Robinson3, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Robinson5, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, Kirsch, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExPrewitt, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExPrewitt, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExPrewitt, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExPrewitt, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExPrewitt, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExPrewitt, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExSobel, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExSobel, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExSobel, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExSobel, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExSobel, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExSobel, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, FDoG, Euclidean, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, FDoG, L1, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, FDoG, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, FDoG, Approx, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, FDoG, Direction, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, FDoG, Signed, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
+template void filterSSE4<float, ExKirsch, Linf, 0>(const EdgeMasksPlane* EDGEMASKS_RESTRICT p, int top, int bottom, void* EDGEMASKS_RESTRICT buffer) noexcept;
 #endif
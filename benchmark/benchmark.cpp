@@ -0,0 +1,191 @@
+// Measures the kernels directly on synthetic frames, without VapourSynth, and prints the results as JSON.
+//
+// Every combination of operator, format, resolution, magnitude and opt the cpu can run is measured unless narrowed down by arguments of the form
+// name=value[,value...], e.g. `benchmark operator=Sobel,Kirsch format=gray8 opt=avx2,avx512`.
+// The names are operator, format (gray8, gray10, gray16, grays), resolution (480p to 4320p), magnitude (0-3) and opt (c, sse4.1, avx2, avx512,
+// portable).
+//
+// Each record holds mpix_per_s; tsc_per_pixel, the ticks of the time stamp counter, which runs at a fixed reference rate rather than the core
+// clock, so it is comparable between runs on one machine only (null off x86); bytes_per_pixel, the frame data a kernel reads and writes, one
+// sample each, as the ring of rows it keeps stays in cache; and gb_per_s, the memory bandwidth that moving those bytes at the measured speed takes.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <new>
+#include <random>
+#include <set>
+
+#include "../EdgeMasks/edgemasks_kernels.h"
+
+#ifdef EDGEMASKS_X86
+#include <x86intrin.h>
+#endif
+
+static uint8_t* allocate(size_t size) {
+    return static_cast<uint8_t*>(operator new[](size, std::align_val_t(64)));
+}
+
+static void release(uint8_t* data) noexcept {
+    operator delete[](data, std::align_val_t(64));
+}
+
+static const char* operators[] = {
+    "Tritical", "Cross", "Prewitt", "Sobel", "Scharr", "RScharr", "Kroon", "Robinson3", "Robinson5", "Kirsch", "ExPrewitt", "ExSobel", "FDoG", "ExKirsch"
+};
+
+static const struct {
+    const char* name;
+    int bitsPerSample, bytesPerSample;
+} formats[] = {
+    { "gray8", 8, 1 },
+    { "gray10", 10, 2 },
+    { "gray16", 16, 2 },
+    { "grays", 32, 4 },
+};
+
+static const struct {
+    const char* name;
+    int width, height;
+} resolutions[] = {
+    { "480p", 854, 480 },
+    { "720p", 1280, 720 },
+    { "1080p", 1920, 1080 },
+    { "2160p", 3840, 2160 },
+    { "4320p", 7680, 4320 },
+};
+
+static const char* opts[] = { "auto", "c", "sse4.1", "avx2", "avx512", "portable" };
+
+int main(int argc, char** argv) {
+    std::map<std::string, std::set<std::string>> filters;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = std::strchr(argv[i], '=');
+
+        if (!value) {
+            std::fprintf(stderr, "usage: %s [name=value[,value...]]...\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        auto& accepted = filters[std::string(argv[i], value - argv[i])];
+
+        for (const char* end = value; *end; value = end) {
+            end = std::strchr(++value, ',');
+            if (!end)
+                end = value + std::strlen(value);
+
+            accepted.emplace(value, end);
+        }
+    }
+
+    auto wanted = [&](const std::string& name, const std::string& value) noexcept {
+        auto it = filters.find(name);
+        return it == filters.end() || it->second.count(value);
+    };
+
+#ifdef EDGEMASKS_X86
+    const int iset = instrset_detect();
+    const bool supported[] = { false, true, iset >= 5, iset >= 8, iset >= 10, true };
+#else
+    const bool supported[] = { false, true, false, false, false, true };
+#endif
+
+    bool first = true;
+    std::printf("[");
+
+    for (const auto& format : formats) {
+        if (!wanted("format", format.name))
+            continue;
+
+        for (const auto& resolution : resolutions) {
+            if (!wanted("resolution", resolution.name))
+                continue;
+
+            const ptrdiff_t stride = (resolution.width * format.bytesPerSample + 63) & ~63;
+            auto src = allocate(stride * resolution.height);
+            auto dst = allocate(stride * resolution.height);
+            auto buffer = allocate(bufferSize(resolution.width, 5));
+
+            std::minstd_rand generator;
+
+            for (int y = 0; y < resolution.height; y++) {
+                for (int x = 0; x < resolution.width; x++) {
+                    if (format.bytesPerSample == 1)
+                        src[stride * y + x] = std::uniform_int_distribution(0, 255)(generator);
+                    else if (format.bytesPerSample == 2)
+                        reinterpret_cast<uint16_t*>(src + stride * y)[x] = std::uniform_int_distribution(0, (1 << format.bitsPerSample) - 1)(generator);
+                    else
+                        reinterpret_cast<float*>(src + stride * y)[x] = std::uniform_real_distribution(0.0f, 1.0f)(generator);
+                }
+            }
+
+            for (int op = 0; op < 14; op++) {
+                if (!wanted("operator", operators[op]))
+                    continue;
+
+                for (int magnitude = 0; magnitude < 4; magnitude++) {
+                    // the compass operators ignore the magnitude, so they are only measured once
+                    if ((isCompass(op) && magnitude > 0) || !wanted("magnitude", std::to_string(magnitude)))
+                        continue;
+
+                    for (int opt = 1; opt < 6; opt++) {
+                        if (!supported[opt] || !wanted("opt", opts[opt]))
+                            continue;
+
+                        // unit scale, which runs the kernels without the multiply of their integer output
+                        const EdgeMasksPlane p{ src, dst, stride, stride, resolution.width, resolution.height, 1.0f, 1, 0,
+                                                format.bitsPerSample == 32 ? 0 : (1 << format.bitsPerSample) - 1 };
+                        const kernel_t filter = selectKernel(op, magnitude, format.bytesPerSample, format.bitsPerSample, opt);
+
+                        // best of at least 3 runs and 0.2 seconds, so that neither small nor large frames are dominated by noise
+                        double seconds = std::numeric_limits<double>::max(), total = 0.0;
+                        uint64_t cycles = std::numeric_limits<uint64_t>::max();
+
+                        for (int run = 0; run < 3 || total < 0.2; run++) {
+                            const auto start = std::chrono::steady_clock::now();
+#ifdef EDGEMASKS_X86
+                            const uint64_t startCycles = __rdtsc();
+#endif
+
+                            filter(&p, 0, resolution.height, buffer);
+
+#ifdef EDGEMASKS_X86
+                            cycles = std::min<uint64_t>(cycles, __rdtsc() - startCycles);
+#endif
+                            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                            seconds = std::min(seconds, elapsed);
+                            total += elapsed;
+                        }
+
+                        const double pixels = static_cast<double>(resolution.width) * resolution.height;
+
+                        std::printf("%s\n  {\"operator\": \"%s\", \"format\": \"%s\", \"resolution\": \"%s\", \"width\": %d, \"height\": %d, \"magnitude\": %d, "
+                                    "\"opt\": \"%s\", \"mpix_per_s\": %.1f, ",
+                                    first ? "" : ",", operators[op], format.name, resolution.name, resolution.width, resolution.height, magnitude, opts[opt],
+                                    pixels / seconds / 1e6);
+#ifdef EDGEMASKS_X86
+                        std::printf("\"tsc_per_pixel\": %.3f, ", cycles / pixels);
+#else
+                        std::printf("\"tsc_per_pixel\": null, ");
+#endif
+                        const int bytesPerPixel = format.bytesPerSample * 2;
+                        std::printf("\"bytes_per_pixel\": %d, \"gb_per_s\": %.2f}", bytesPerPixel, bytesPerPixel * pixels / seconds / 1e9);
+                        std::fflush(stdout);
+                        first = false;
+                    }
+                }
+            }
+
+            release(src);
+            release(dst);
+            release(buffer);
+        }
+    }
+
+    std::printf("\n]\n");
+    return EXIT_SUCCESS;
+}
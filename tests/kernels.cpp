@@ -0,0 +1,323 @@
+// Runs every SIMD kernel the cpu supports against the C kernel on randomized planes: widths around the vector sizes and the strip width, rows
+// padded with garbage, pixels at 0 and peak, several scales and thresholds, and planes split into bands. Integer output has to match bit for bit, float output
+// to within a few ulp. Also checks the C API against the kernels it wraps, and Canny for seams, binary output and thin edges.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+
+#include "../EdgeMasks/edgemasks_api.h"
+#include "../EdgeMasks/edgemasks_kernels.h"
+
+static uint8_t* allocate(size_t size) {
+    return static_cast<uint8_t*>(operator new[](size, std::align_val_t(64)));
+}
+
+static void release(uint8_t* data) noexcept {
+    operator delete[](data, std::align_val_t(64));
+}
+
+static const char* operators[] = {
+    "Tritical", "Cross", "Prewitt", "Sobel", "Scharr", "RScharr", "Kroon", "Robinson3", "Robinson5", "Kirsch", "ExPrewitt", "ExSobel", "FDoG", "ExKirsch"
+};
+
+static const char* opts[] = { "auto", "c", "sse4.1", "avx2", "avx512", "portable" };
+
+// every bit depth the narrow and wide integer kernels are selected for
+static const int depths[] = { 8, 9, 10, 11, 12, 14, 16, 32 };
+
+// 3 and 5 are the smallest planes; 7-9, 15-17, 31-33 and 63-65 straddle the vector sizes; 3000 is split into strips for the wider rings
+static const int widths[] = { 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 3000 };
+static const int heights[] = { 3, 5, 6, 17 };
+
+static const float scales[] = { 1.0f, 0.3f, 0.7f, 2.5f };
+
+// thr_lo and thr_hi as fractions of the peak, one pair for each scale: none, a binary mask, a clipped range, and a low threshold alone
+static const float thresholds[][2] = { { 0.0f, INFINITY }, { 0.25f, 0.25f }, { 0.103f, 0.6f }, { 0.05f, INFINITY } };
+
+enum Pattern {
+    Random,
+    Extremes,
+    Checkerboard,
+    Peak
+};
+
+// ulps between two finite floats of the same sign, or a large number if their signs differ
+static int64_t ulps(float a, float b) noexcept {
+    int32_t ia, ib;
+    std::memcpy(&ia, &a, sizeof(a));
+    std::memcpy(&ib, &b, sizeof(b));
+
+    if ((ia < 0) != (ib < 0))
+        return a == b ? 0 : INT32_MAX;
+
+    return std::abs(static_cast<int64_t>(ia) - ib);
+}
+
+int main() {
+#ifdef EDGEMASKS_X86
+    const int iset = instrset_detect();
+    const bool supported[] = { false, false, iset >= 5, iset >= 8, iset >= 10, true };
+#else
+    const bool supported[] = { false, false, false, false, false, true };
+#endif
+
+    std::mt19937 generator;
+    int64_t runs = 0, failures = 0;
+
+    for (int bits : depths) {
+        const int bytesPerSample = bits == 32 ? 4 : (bits > 8 ? 2 : 1);
+        const int peak = bits == 32 ? 0 : (1 << bits) - 1;
+
+        for (int width : widths) {
+            for (int height : heights) {
+                // rows padded by one to three 64-byte units beyond the usual alignment, all of it garbage the kernels must not let through
+                const ptrdiff_t stride = ((width * bytesPerSample + 63) & ~63) + 64 * std::uniform_int_distribution(1, 3)(generator);
+
+                auto src = allocate(stride * height);
+                // gy of Signed goes below gx
+                auto ref = allocate(stride * height * 2);
+                auto out = allocate(stride * height * 2);
+                auto buffer = allocate(bufferSize(width, 5));
+
+                for (int pattern = Random; pattern <= Peak; pattern++) {
+                    for (ptrdiff_t i = 0; i < stride * height; i++)
+                        src[i] = generator();
+
+                    for (int y = 0; y < height; y++) {
+                        for (int x = 0; x < width; x++) {
+                            const bool high = pattern == Peak || (pattern == Checkerboard && (x + y) % 2) ||
+                                              (pattern == Extremes && std::uniform_int_distribution(0, 1)(generator));
+
+                            if (bits == 32) {
+                                reinterpret_cast<float*>(src + stride * y)[x] =
+                                    pattern == Random ? std::uniform_real_distribution(0.0f, 1.0f)(generator) : (high ? 1.0f : 0.0f);
+                            } else {
+                                const int value = pattern == Random ? std::uniform_int_distribution(0, peak)(generator) : (high ? peak : 0);
+
+                                if (bytesPerSample == 1)
+                                    src[stride * y + x] = value;
+                                else
+                                    reinterpret_cast<uint16_t*>(src + stride * y)[x] = value;
+                            }
+                        }
+                    }
+
+                    for (int op = 0; op < 14; op++) {
+                        const int matrix = (op == ExPrewitt || op == ExSobel || op == FDoG || op == ExKirsch) ? 5 : 3;
+
+                        if (width < matrix || height < matrix)
+                            continue;
+
+                        for (int magnitude = 0; magnitude <= Signed; magnitude++) {
+                            if (isCompass(op) && magnitude > 0)
+                                continue;
+
+                            for (int s = 0; s < 4; s++) {
+                                const float scale = scales[s];
+                                EdgeMasksPlane p{ src, ref, stride, stride, width, height, scale, 0, 0, peak };
+                                foldScale(&p, op, magnitude);
+                                setThresholds(&p, thresholds[s][0] * (peak ? peak : 1), thresholds[s][1] * (peak ? peak : 1));
+
+                                // direction in 8 and 16 sectors, and in radians for float
+                                p.bins = s % 2 ? 16 : (bits == 32 && s == 0 ? 0 : 8);
+
+                                // presmoothing of both radii, which goes through the ring of rows of the strips and bands
+                                p.presmooth = (s + pattern) % 3;
+
+                                if ((magnitude == Direction && s > 0) || magnitude == Signed)
+                                    setThresholds(&p, 0.0f, INFINITY);
+
+                                p.dstpGy = ref + stride * height;
+                                selectKernel(op, magnitude, bytesPerSample, bits, 1)(&p, 0, height, buffer);
+                                p.dstp = out;
+                                p.dstpGy = out + stride * height;
+
+                                for (int opt = 2; opt < 6; opt++) {
+                                    if (!supported[opt])
+                                        continue;
+
+                                    // the bands a frame is split into for threads, which have to join without seams
+                                    const int bands = std::uniform_int_distribution(1, std::min(height, 3))(generator);
+
+                                    for (int i = 0; i < bands; i++)
+                                        selectKernel(op, magnitude, bytesPerSample, bits, opt)(&p, height * i / bands, height * (i + 1) / bands, buffer);
+
+                                    runs++;
+
+                                    for (int y = 0; y < (magnitude == Signed ? height * 2 : height); y++) {
+                                        const uint8_t* refp = ref + stride * y;
+                                        const uint8_t* outp = out + stride * y;
+                                        int x = 0;
+
+                                        if (bits == 32) {
+                                            for (; x < width; x++)
+                                                if (ulps(reinterpret_cast<const float*>(refp)[x], reinterpret_cast<const float*>(outp)[x]) > 4)
+                                                    break;
+                                        } else {
+                                            x = static_cast<int>(
+                                                std::mismatch(refp, refp + width * bytesPerSample, outp).first - refp) / bytesPerSample;
+                                        }
+
+                                        if (x < width) {
+                                            if (++failures <= 20)
+                                                std::fprintf(stderr, "%s magnitude=%d bits=%d %s: %dx%d scale=%g pattern=%d bands=%d mismatch at (%d, %d)\n",
+                                                             operators[op], magnitude, bits, opts[opt], width, height, scale, pattern, bands, x, y);
+                                            break;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+
+                release(src);
+                release(ref);
+                release(out);
+                release(buffer);
+            }
+        }
+    }
+
+    // the C API on top of the same kernels, which has to normalize scale like the plugin and refuse planes the SIMD kernels cannot take
+    {
+        constexpr int width = 100, height = 20;
+        constexpr ptrdiff_t stride = 256;
+
+        auto src = allocate(stride * height);
+        auto ref = allocate(stride * height);
+        auto out = allocate(stride * height);
+        auto buffer = allocate(bufferSize(width, 5));
+
+        for (ptrdiff_t i = 0; i < stride * height / 2; i++)
+            reinterpret_cast<uint16_t*>(src)[i] = std::uniform_int_distribution(0, 1023)(generator);
+
+        for (int op = 0; op < 14; op++) {
+            // no upper threshold, a clipped range, and a thr_hi of 0, which turns every pixel to the peak
+            const EdgeMasksParams params{ 10, 0, 1.5f, op % 4 == 3 ? 0.0f : 100.0f, op % 4 == 3 ? 0.0f : (op % 2 ? INFINITY : 700.0f), op % 3 };
+            EdgeMasksPlane p{ src, ref, stride, stride, width, height, params.scale / operatorNorm(op), 0, 0, 1023 };
+            p.presmooth = params.presmooth;
+            foldScale(&p, op, params.magnitude);
+            setThresholds(&p, params.thr_lo, params.thr_hi);
+            selectKernel(op, params.magnitude, 2, 10, 1)(&p, 0, height, buffer);
+
+            runs++;
+
+            bool same = edgemasks_process_plane(static_cast<EdgeMasksOperator>(op), EDGEMASKS_UINT16, src, stride, out, stride, width, height,
+                                                &params, EDGEMASKS_ISA_AUTO) == EDGEMASKS_OK;
+
+            for (int y = 0; y < height && same; y++)
+                same = !std::memcmp(ref + stride * y, out + stride * y, width * 2);
+
+            if (!same) {
+                if (++failures <= 20)
+                    std::fprintf(stderr, "%s: edgemasks_process_plane differs from the C kernel\n", operators[op]);
+            }
+        }
+
+        const EdgeMasksParams params{ 8, 0, 1.0f, 0.0f, INFINITY, 0 };
+        runs++;
+
+        if (edgemasks_process_plane(EDGEMASKS_SOBEL, EDGEMASKS_UINT8, src, stride - 1, out, stride, width, height, &params, EDGEMASKS_ISA_C) !=
+                EDGEMASKS_ERROR_ARGUMENT ||
+            edgemasks_process_plane(EDGEMASKS_SOBEL, EDGEMASKS_UINT8, src + 1, stride, out, stride, width, height, &params, EDGEMASKS_ISA_C) !=
+                EDGEMASKS_ERROR_ARGUMENT ||
+            edgemasks_process_plane(EDGEMASKS_EXSOBEL, EDGEMASKS_UINT8, src, stride, out, stride, width, 4, &params, EDGEMASKS_ISA_C) !=
+                EDGEMASKS_ERROR_ARGUMENT) {
+            if (++failures <= 20)
+                std::fprintf(stderr, "edgemasks_process_plane accepts an invalid plane\n");
+        }
+
+        release(src);
+        release(ref);
+        release(out);
+        release(buffer);
+    }
+
+    // Canny, which has no SIMD kernels to compare with: bands have to join without seams, the output has to be binary, and a step has to come out
+    // as a single line of pixels
+    for (int bits : { 8, 10, 32 }) {
+        constexpr int width = 77, height = 40;
+        const int bytesPerSample = bits == 32 ? 4 : (bits > 8 ? 2 : 1);
+        const int peak = bits == 32 ? 0 : (1 << bits) - 1;
+        const float top = peak ? peak : 1.0f;
+        const ptrdiff_t stride = ((width * bytesPerSample + 63) & ~63) + 64;
+
+        auto src = allocate(stride * height);
+        auto ref = allocate(stride * height);
+        auto out = allocate(stride * height);
+        auto buffer = allocate(cannyBufferSize(width));
+        auto queue = allocate(hysteresisQueueSize(width, height));
+
+        for (int step = 0; step < 2; step++) {
+            // smooth blobs under noise, or a vertical step at x = 30
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    const float value = step ? (x < 30 ? 0.2f : 0.8f)
+                                             : 0.5f + 0.3f * std::sin(x * 0.3f) * std::cos(y * 0.25f) +
+                                                   std::uniform_real_distribution(-0.05f, 0.05f)(generator);
+
+                    if (bits == 32)
+                        reinterpret_cast<float*>(src + stride * y)[x] = value;
+                    else if (bytesPerSample == 1)
+                        src[stride * y + x] = static_cast<uint8_t>(value * peak + 0.5f);
+                    else
+                        reinterpret_cast<uint16_t*>(src + stride * y)[x] = static_cast<uint16_t>(value * peak + 0.5f);
+                }
+            }
+
+            for (int op : { Sobel, Scharr }) {
+                EdgeMasksPlane p{ src, ref, stride, stride, width, height, 1.0f / operatorNorm(op), 0, 0, peak };
+                setThresholds(&p, top * 0.1f, top * 0.2f);
+
+                selectCanny(op, 0, bytesPerSample)(&p, 0, height, buffer);
+                selectHysteresis(bytesPerSample)(&p, queue);
+
+                p.dstp = out;
+                selectCanny(op, 0, bytesPerSample)(&p, 0, 13, buffer);
+                selectCanny(op, 0, bytesPerSample)(&p, 13, 27, buffer);
+                selectCanny(op, 0, bytesPerSample)(&p, 27, height, buffer);
+                selectHysteresis(bytesPerSample)(&p, queue);
+
+                runs++;
+
+                bool same = true, binary = true, thin = true;
+
+                for (int y = 0; y < height; y++) {
+                    same = same && !std::memcmp(ref + stride * y, out + stride * y, width * bytesPerSample);
+
+                    int edges = 0;
+
+                    for (int x = 0; x < width; x++) {
+                        const float value = bits == 32 ? reinterpret_cast<const float*>(ref + stride * y)[x]
+                                                       : (bytesPerSample == 1 ? ref[stride * y + x] : reinterpret_cast<const uint16_t*>(ref + stride * y)[x]);
+
+                        binary = binary && (value == 0.0f || value == top);
+                        edges += value == top;
+                    }
+
+                    thin = thin && (!step || edges == 1);
+                }
+
+                if (!same || !binary || !thin) {
+                    if (++failures <= 20)
+                        std::fprintf(stderr, "Canny %s bits=%d step=%d:%s%s%s\n", operators[op], bits, step, same ? "" : " bands differ",
+                                     binary ? "" : " not binary", thin ? "" : " step not one pixel wide");
+                }
+            }
+        }
+
+        release(src);
+        release(ref);
+        release(out);
+        release(buffer);
+        release(queue);
+    }
+
+    std::printf("%lld runs, %lld failures\n", static_cast<long long>(runs), static_cast<long long>(failures));
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}